@@ -2,6 +2,9 @@
 
 #include "imgui_impl_opengl3.h"
 #include "imgui_impl_glfw.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
 
 //    ImGui     -
 void EditorUI::beginFrame()
@@ -12,23 +15,24 @@ void EditorUI::beginFrame()
 }
 
 //  UI    
-void EditorUI::render(Model* model)
+void EditorUI::render(Model* model, const ModelLoader& loader)
 {
-    drawModelWindow(); //    
+    drawModelWindow(model, loader); //    
 
     ImGuiIO& io = ImGui::GetIO();
 
     if (model)
     {
-        int selected = model->getSelectedMesh();
-        if (selected != -1) //    
+        int selected = model->getSelectedInstance();
+        if (selected != -1) //     
         {
-            std::string selectedInfo = model->getMeshInfo(selected);
+            const MeshInstance& instance = model->getInstance(selected);
+            std::string selectedInfo = model->getMeshInfo(instance.mesh);
 
             ImGuiIO& io = ImGui::GetIO();
             ImVec2 infoPos(io.DisplaySize.x - 300, 10); // , 300   
             ImGui::SetNextWindowPos(infoPos, ImGuiCond_Always);
-            ImGui::SetNextWindowSize(ImVec2(280, 150)); //  
+            ImGui::SetNextWindowSize(ImVec2(280, 240)); //  
 
             ImGuiWindowFlags flags = ImGuiWindowFlags_NoTitleBar |
                 ImGuiWindowFlags_NoResize |
@@ -39,13 +43,45 @@ void EditorUI::render(Model* model)
             ImGui::Begin("Mesh Info", nullptr, flags);
 
             ImGui::TextWrapped("%s", selectedInfo.c_str());
+            ImGui::Text("Instance %d of mesh %u (%u instance(s))", selected, instance.mesh,
+                model->getMeshInstanceCount(instance.mesh));
+
+            //   :        
+            const Mesh& mesh = model->getMesh(instance.mesh);
+            ImGui::Text("Triangles: %d", static_cast<int>(mesh.getLod(0).indexCount / 3));
+            for (unsigned int lod = 1; lod < mesh.getLodCount(); ++lod)
+                ImGui::Text("LOD %u: %d triangles, error %.3g", lod,
+                    static_cast<int>(mesh.getLod(lod).indexCount / 3), mesh.getLod(lod).error);
+            if (mesh.verticesBeforeWeld)
+                ImGui::Text("Welded: %d -> %d vertices (x%.2f)", static_cast<int>(mesh.verticesBeforeWeld),
+                    static_cast<int>(mesh.getVertexCount()), double(mesh.verticesBeforeWeld) / std::max<size_t>(mesh.getVertexCount(), 1));
+            ImGui::Text("ACMR %.3f -> %.3f", mesh.cacheBefore.acmr, mesh.cacheAfter.acmr);
+            ImGui::Text("ATVR %.3f -> %.3f", mesh.cacheBefore.atvr, mesh.cacheAfter.atvr);
+            if (mesh.overdrawBefore > 0.0f)
+                ImGui::Text("Overdraw %.3f -> %.3f", mesh.overdrawBefore, mesh.overdrawAfter);
+            else
+                ImGui::TextDisabled("Overdraw: not measured");
+
+            //              
+            SceneGraph& graph = model->getSceneGraph();
+            const uint32_t node = instance.node;
+            if (model != editedModel || node != editedNode)
+            {
+                editedModel = model;
+                editedNode = node;
+                editedNodeBase = graph.getLocal(node);
+                nodeOffset = glm::vec3(0.0f);
+            }
+            ImGui::Text("Node %u: %u node(s) in subtree", node, graph.getSubtreeEnd(node) - node);
+            if (ImGui::DragFloat3("Offset", &nodeOffset.x, 0.01f))
+                graph.setLocal(node, glm::translate(glm::mat4(1.0f), nodeOffset) * editedNodeBase);
 
             ImGui::End();
         }
     }
 
     //   Debug
-    ImVec2 windowSize(200, 80); // <--  !
+    ImVec2 windowSize(320, 330); // <--  !
 
     //      
     ImVec2 windowPos(10.0f, ImGui::GetIO().DisplaySize.y - windowSize.y - 10.0f);
@@ -55,7 +91,7 @@ void EditorUI::render(Model* model)
     if (ImGui::Button("Show All Meshes")) //   UI
     {
         if (model)
-            model->selectMesh(-1); //  ,   
+            model->selectInstance(-1); //  ,   
     }
 
     static bool pickingEnabled = true;
@@ -64,13 +100,67 @@ void EditorUI::render(Model* model)
     if (model)
         model->setPickingEnabled(pickingEnabled);
 
+    //  LOD    ; 0    
+    static float lodThreshold = 1.0f;
+    ImGui::SliderFloat("LOD error, px", &lodThreshold, 0.0f, 8.0f, "%.1f");
+    if (model)
+    {
+        model->setLodThreshold(lodThreshold);
+        ImGui::Text("Drawn: %d / %d triangles", static_cast<int>(model->getDrawnTriangles()),
+            static_cast<int>(model->getFullTriangles()));
+    }
+
+    //  ;      ,    
+    static bool clusterCulling = true;
+    static bool backfaceClusters = false;
+    ImGui::Checkbox("Cluster culling", &clusterCulling);
+    ImGui::Checkbox("Cull back-facing clusters", &backfaceClusters);
+    if (model)
+    {
+        model->setClusterCulling(clusterCulling, backfaceClusters);
+        const ClusterStats& clusters = model->getClusterStats();
+        if (clusters.tested)
+            ImGui::Text("Clusters: %d tested, %d frustum, %d back, %d drawn",
+                static_cast<int>(clusters.tested), static_cast<int>(clusters.frustumCulled),
+                static_cast<int>(clusters.backfaceCulled), static_cast<int>(clusters.drawn));
+    }
+
+    //    ;       "Shared buffers"
+    //   "Indirect draw" (         )
+    static bool indirectDraw = true;
+    ImGui::Checkbox("Indirect draw", &indirectDraw);
+    if (model)
+    {
+        model->setIndirectDraw(indirectDraw);
+        ImGui::Text("Draw submit: %.3f ms, %d calls (%s)", model->getDrawSubmitMs(),
+            static_cast<int>(model->getDrawCalls()),
+            model->usesIndirectDraw() ? "indirect" : model->usesSharedBuffers() ? "shared buffers" : "per-mesh buffers");
+        if (ImGui::Button("Benchmark draw"))
+            benchmarkDrawRequested = true;
+        if (lastBenchmark.frames)
+            ImGui::Text("%d draws: %.3f ms submit, %.3f ms GPU (%s)", static_cast<int>(lastBenchmark.frames),
+                lastBenchmark.submitMs, lastBenchmark.finishMs, lastBenchmark.indirect ? "indirect" : lastBenchmark.sharedBuffers ? "shared" : "per-mesh");
+
+        //   :   ,    
+        ImGui::Text("Scene graph: %d nodes, %d updated, %.3f ms", static_cast<int>(model->getSceneGraph().getNodeCount()),
+            static_cast<int>(model->getNodesUpdated()), model->getSceneUpdateMs());
+    }
+
+    //   50  , 8   :     
+    if (ImGui::Button("Benchmark scene graph"))
+        lastSceneGraphBenchmark = benchmarkSceneGraph(50000, 8, 100);
+    if (lastSceneGraphBenchmark.frames)
+        ImGui::Text("%d nodes: %.3f ms incremental (%d), %.3f ms full", static_cast<int>(lastSceneGraphBenchmark.nodes),
+            lastSceneGraphBenchmark.incrementalMs, static_cast<int>(lastSceneGraphBenchmark.updatedPerFrame),
+            lastSceneGraphBenchmark.fullMs);
+
     ImGui::End();
 
     ImGui::Render(); //  
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData()); //   OpenGL
 }
 
-void EditorUI::drawModelWindow()
+void EditorUI::drawModelWindow(Model* model, const ModelLoader& loader)
 {
     //     
     ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_Always);
@@ -83,8 +173,161 @@ void EditorUI::drawModelWindow()
         ImGuiWindowFlags_AlwaysAutoResize
     );
 
-    if (ImGui::Button("3D_Model", ImVec2(120, 40)))
+    if (loader.isBusy())
+    {
+        //   : ,   
+        ImGui::ProgressBar(loader.getStageProgress(), ImVec2(240, 0), loader.getStageName());
+        if (ImGui::Button("Cancel", ImVec2(120, 40)))
+            cancelLoadRequested = true;
+    }
+    else if (ImGui::Button("3D_Model", ImVec2(120, 40)))
+    {
         loadModelRequested = true;
+    }
+
+    ImGui::Checkbox("Background loading", &backgroundLoading);
+    //       ,   .mtl   
+    ImGui::Checkbox("Hot reload", &hotReload);
+    if (hotReload)
+    {
+        ImGui::Text("Watching %d files; reloads: %u model, %u textures",
+            static_cast<int>(hotReloadStats.watchedFiles), hotReloadStats.modelReloads, hotReloadStats.textureReloads);
+        if (hotReloadStats.textureReloads)
+            ImGui::Text("Last: %u textures in %.1f ms", hotReloadStats.lastTextures, hotReloadStats.lastTextureMs);
+    }
+    // 16     88;     
+    ImGui::Checkbox("Packed vertices", &importOptions.packVertices);
+    //    Assimp    ;      Custom
+    int profile = static_cast<int>(findImportProfile(importOptions));
+    if (ImGui::Combo("Import profile", &profile, "Fast preview\0Balanced\0Max quality\0Custom\0"))
+        applyImportProfile(importOptions, static_cast<ImportProfile>(profile));
+    //     ;     
+    ImGui::Checkbox("Weld vertices", &importOptions.weldVertices);
+    if (importOptions.weldVertices)
+        ImGui::InputFloat("Weld epsilon", &importOptions.weldEpsilon, 0.0f, 0.0f, "%.6f");
+    //         
+    ImGui::Checkbox("Optimize vertex cache", &importOptions.optimizeVertexCache);
+    //       6     
+    ImGui::Checkbox("Optimize overdraw", &importOptions.optimizeOverdraw);
+    ImGui::Checkbox("Generate LODs", &importOptions.generateLods);
+    ImGui::Checkbox("Build meshlets", &importOptions.buildMeshlets);
+    ImGui::Checkbox("Shared buffers", &importOptions.sharedBuffers);
+    //      CPU    GPU;     MeshResidency
+    int residency = static_cast<int>(importOptions.residency);
+    if (ImGui::Combo("CPU geometry", &residency, "All\0Positions\0Bounds\0"))
+        importOptions.residency = static_cast<MeshResidency>(residency);
+    // .glb  Assimp;     ,     
+    ImGui::Checkbox("Native GLB loader", &importOptions.nativeGltf);
+    ImGui::Checkbox("Native OBJ loader", &importOptions.nativeObj);
+    if (!loader.isBusy() && ImGui::Button("Compare loaders"))
+        compareLoadersRequested = true;
+    // OBJ    ;      
+    ImGui::SliderInt("OBJ size, MB", &benchmarkObjMegabytes, 1, 1024);
+    if (!loader.isBusy() && ImGui::Button("Benchmark OBJ"))
+        benchmarkObjRequested = true;
+    if (lastComparison.runs)
+    {
+        const double megabytes = lastComparison.bytes / (1024.0 * 1024.0);
+        if (lastComparison.native)
+            ImGui::Text("%s %.2f ms (%.0f MB/s), Assimp %.2f ms (%.0f MB/s), %s", lastComparison.loader,
+                lastComparison.nativeMs, megabytes * 1000.0 / lastComparison.nativeMs,
+                lastComparison.assimpMs, megabytes * 1000.0 / lastComparison.assimpMs,
+                lastComparison.identical ? "same meshes" : "meshes differ");
+        else
+            ImGui::Text("%s: %s; Assimp %.2f ms", lastComparison.loader, lastComparison.reason.c_str(),
+                lastComparison.assimpMs);
+    }
+
+    //     LOD     ;    ,  
+    ImGui::Checkbox("Scratch arena", &importOptions.scratchArena);
+    if (!loader.isBusy() && ImGui::Button("Benchmark import"))
+        benchmarkImportRequested = true;
+    if (lastImportBenchmark.runs)
+        ImGui::Text("%s: %.1f ms per import, RSS %d -> %d MB, peak %d MB",
+            lastImportBenchmark.scratchArena ? "Arena" : "Heap", lastImportBenchmark.loadMs,
+            static_cast<int>(lastImportBenchmark.rssBefore / (1024 * 1024)),
+            static_cast<int>(lastImportBenchmark.rssAfter / (1024 * 1024)),
+            static_cast<int>(lastImportBenchmark.peakRss / (1024 * 1024)));
+
+    //      (0    ):   
+    int threads = static_cast<int>(importOptions.threads);
+    if (ImGui::SliderInt("Threads", &threads, 0, static_cast<int>(ThreadPool::hardwareThreads())))
+        importOptions.threads = static_cast<unsigned int>(threads);
+
+    //   :         Assimp
+    if (model && !loader.isBusy())
+    {
+        const ImportStats& stats = model->getImportStats();
+        ImGui::Text("%s: %.1f ms", stats.fromCache ? "Cache" : stats.parser, stats.loadMs);
+        if (!stats.fromCache)
+            ImGui::Text("Parse: %.1f ms, convert: %.1f ms on %u thread(s)", stats.parseMs, stats.convertMs, stats.threads);
+        //        ;      
+        if (!stats.steps.empty() && ImGui::TreeNode("steps", "Steps (%s)", importProfileName(stats.profile)))
+        {
+            for (const ImportStepTiming& step : stats.steps)
+                ImGui::Text("%s: %.2f ms%s", step.name, step.ms, step.threadTime ? " (threads)" : "");
+            ImGui::TreePop();
+        }
+        if (stats.allocationsMax)
+            ImGui::Text("Heap allocations per mesh: %d..%d",
+                static_cast<int>(stats.allocationsMin), static_cast<int>(stats.allocationsMax));
+        if (stats.allocationMismatches)
+            ImGui::Text("Unexpected allocations in %u meshes", stats.allocationMismatches);
+        if (stats.scratchPeakBytes)
+            ImGui::Text("Scratch arenas: %.1f MB peak", stats.scratchPeakBytes / (1024.0 * 1024.0));
+        ImGui::Text("Process memory: %.1f MB", stats.residentBytes / (1024.0 * 1024.0));
+
+        //    ;       
+        if (!stats.textures.empty())
+        {
+            double decodeMs = 0.0, uploadMs = 0.0;
+            for (const TextureTiming& t : stats.textures)
+            {
+                decodeMs += t.decodeMs;
+                uploadMs += t.uploadMs;
+            }
+            ImGui::Text("Textures: %d, decode %.1f ms, upload %.1f ms",
+                static_cast<int>(stats.textures.size()), decodeMs, uploadMs);
+        }
+        ImGui::Text("Triangles: %d, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f",
+            static_cast<int>(stats.triangles), stats.cacheBefore.acmr, stats.cacheAfter.acmr,
+            stats.cacheBefore.atvr, stats.cacheAfter.atvr);
+        if (stats.weldVerticesAfter)
+            ImGui::Text("Welding: %d -> %d vertices in %u mesh(es), x%.2f", static_cast<int>(stats.weldVerticesBefore),
+                static_cast<int>(stats.weldVerticesAfter), stats.weldedMeshes,
+                double(stats.weldVerticesBefore) / stats.weldVerticesAfter);
+        if (stats.overdrawTriangles)
+            ImGui::Text("Overdraw: %.3f -> %.3f", stats.overdrawBefore, stats.overdrawAfter);
+        if (stats.meshlets)
+            ImGui::Text("Meshlets: %d", static_cast<int>(stats.meshlets));
+        if (stats.lodMeshes)
+            ImGui::Text("LODs: %u mesh(es), %d coarse triangles", stats.lodMeshes, static_cast<int>(stats.lodTriangles));
+        ImGui::Text("Vertices: %.1f MB (%.1f MB as full Vertex)",
+            stats.vertexBytes / (1024.0 * 1024.0), stats.vertexBytesFull / (1024.0 * 1024.0));
+        for (unsigned int f = 0; f < VERTEX_FORMAT_COUNT; ++f)
+        {
+            if (stats.meshesByFormat[f])
+                ImGui::BulletText("%s: %u mesh(es), %u bytes/vertex", vertexFormatName(VertexFormat(f)),
+                    stats.meshesByFormat[f], static_cast<unsigned int>(vertexSize(VertexFormat(f))));
+        }
+        //           
+        if (stats.instances > model->getMeshCount())
+            ImGui::Text("Instances: %d of %d meshes, %.1f MB of copies not uploaded", static_cast<int>(stats.instances),
+                static_cast<int>(model->getMeshCount()), stats.instancedBytesSaved / (1024.0 * 1024.0));
+        ImGui::Text("Indices: %.1f MB, 16-bit in %u/%d meshes, saved %.1f MB",
+            stats.indexBytes / (1024.0 * 1024.0), stats.shortIndexMeshes,
+            static_cast<int>(model->getMeshCount()), stats.indexBytesSaved / (1024.0 * 1024.0));
+        if (stats.meshesByFormat[static_cast<unsigned int>(VertexFormat::Packed)] && !stats.fromCache)
+            ImGui::Text("Max error: pos %.2g, normal %.3f deg, uv %.2g",
+                stats.quantization.position, stats.quantization.normalDegrees, stats.quantization.texCoord);
+        if (stats.texturesShared)
+            ImGui::Text("Textures reused: %u", stats.texturesShared);
+        if (stats.meshesReused)
+            ImGui::Text("GPU buffers reused: %u meshes, %.1f MB not uploaded",
+                stats.meshesReused, stats.reusedBytes / (1024.0 * 1024.0));
+        ImGui::Text("CPU memory: %.2f MB after upload, %.2f MB resident",
+            stats.cpuBytesBefore / (1024.0 * 1024.0), stats.cpuBytesAfter / (1024.0 * 1024.0));
+    }
 
     ImGui::End();
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include "imgui.h"
 #include <Model.h>
+#include "ModelLoader.h"
+#include "HotReload.h"
 
 //     (UI) 
 class EditorUI
@@ -10,10 +12,30 @@ public:
 	//    ImGui        
 	void beginFrame();
 	//  UI    
-	void render(Model* model);
+	void render(Model* model, const ModelLoader& loader);
 
 	bool loadModelRequested = false;
+	bool cancelLoadRequested = false;
+	bool backgroundLoading = true; //   ,   
+	bool hotReload = false;        //       
+	HotReloadStats hotReloadStats;
+	ImportOptions importOptions; //     
+	bool benchmarkDrawRequested = false; //  Draw   ,   
+	DrawBenchmark lastBenchmark; //   
+	bool compareLoadersRequested = false; //       Assimp
+	bool benchmarkObjRequested = false;   //     OBJ  benchmarkObjMegabytes
+	int benchmarkObjMegabytes = 64;
+	LoaderComparison lastComparison;
+	bool benchmarkImportRequested = false; //         
+	ImportBenchmark lastImportBenchmark;
+	SceneGraphBenchmark lastSceneGraphBenchmark;
 
 private:
-	void drawModelWindow(); //       
+	//    :        
+	const Model* editedModel = nullptr;
+	uint32_t editedNode = SceneGraph::NO_PARENT;
+	glm::mat4 editedNodeBase = glm::mat4(1.0f);
+	glm::vec3 nodeOffset = glm::vec3(0.0f);
+
+	void drawModelWindow(Model* model, const ModelLoader& loader); //       
 };
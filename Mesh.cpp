@@ -1,6 +1,99 @@
 #include <glad/glad.h>
 #include "Mesh.h"
 #include "Shader.h"
+#include "Bounds.h"
+#include "Hash.h"
+#include "VertexPacking.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+	//  VAO    V:   ,   V .
+	//     layout(location)  .
+	template <class V>
+	void setupVertexAttributes()
+	{
+		typedef VertexTraits<V> Traits;
+
+		// vertex positions
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(V), (void*)offsetof(V, Position));
+		// vertex normals
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(V), (void*)offsetof(V, Normal));
+
+		if constexpr (Traits::texCoords)
+		{
+			// vertex texture coords
+			glEnableVertexAttribArray(2);
+			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(V), (void*)offsetof(V, TexCoords));
+		}
+
+		if constexpr (Traits::tangents)
+		{
+			// vertex tangent
+			glEnableVertexAttribArray(3);
+			glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(V), (void*)offsetof(V, Tangent));
+			// vertex bitangent
+			glEnableVertexAttribArray(4);
+			glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(V), (void*)offsetof(V, Bitangent));
+		}
+
+		if constexpr (Traits::bones)
+		{
+			// ids
+			glEnableVertexAttribArray(5);
+			glVertexAttribIPointer(5, 4, GL_INT, sizeof(V), (void*)offsetof(V, m_BoneIDs));
+			// weights
+			glEnableVertexAttribArray(6);
+			glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(V), (void*)offsetof(V, m_Weights));
+		}
+	}
+
+	template <>
+	void setupVertexAttributes<PackedVertex>()
+	{
+		// : unorm16 -> 0..1   
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, Position));
+		// :  , snorm16 -> -1..1
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, Normal));
+		//  : half float
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, TexCoords));
+	}
+}
+
+const void* MeshData::indexData() const
+{
+	if (shortIndices.empty())
+		return indices.data();
+	return shortIndices.data();
+}
+
+uint64_t MeshData::computeContentHash() const
+{
+	const uint32_t layout[2] = { static_cast<uint32_t>(format), indexSize() };
+	uint64_t hash = fnv1a(layout, sizeof(layout));
+	hash = fnv1aWords(vertices.data(), vertices.size(), hash);
+	return fnv1aWords(indexData(), indexCount() * indexSize(), hash);
+}
+
+bool MeshData::compactIndices()
+{
+	if (vertexCount() > MAX_SHORT_INDEX_VERTICES || indices.empty())
+		return false;
+
+	shortIndices.assign(indices.begin(), indices.end());
+	indices.clear();
+	indices.shrink_to_fit();
+	return true;
+}
 
 Mesh::Mesh(
 	std::vector<Vertex> vertices,
@@ -8,15 +101,91 @@ Mesh::Mesh(
 	std::vector<Texture> textures
 )
 {
-	this->vertices = vertices;
-	this->indices = indices;
+	this->vertices.resize(vertices.size() * sizeof(Vertex));
+	if (!vertices.empty())
+		std::memcpy(this->vertices.data(), vertices.data(), this->vertices.size());
+	this->indices = std::move(indices);
+	this->textures = std::move(textures);
+	this->format = VertexFormat::Full;
+
+	//  
+	if (!vertices.empty())
+	{
+		positionBounds(vertices.data(), vertices.size(), sizeof(Vertex), boundsMin, boundsMax);
+		sphereCenter = (boundsMin + boundsMax) * 0.5f;
+		sphereRadius = boundingRadius(vertices.data(), vertices.size(), sizeof(Vertex), sphereCenter);
+	}
+
+	setupMesh(this->vertices.data(), vertices.size(), this->indices.data(), this->indices.size());
+}
+
+Mesh::Mesh(MeshData&& data, std::vector<Texture> textures, Mesh* donor)
+{
+	size_t count = data.vertexCount();
+	size_t indexCount = data.indexCount();
+
+	this->indexSize = data.indexSize();
+	this->vertices = std::move(data.vertices);
+	this->indices = std::move(data.indices);
+	this->shortIndices = std::move(data.shortIndices);
+	this->textures = std::move(textures);
+	this->boundsMin = data.boundsMin;
+	this->boundsMax = data.boundsMax;
+	this->sphereCenter = data.sphereCenter;
+	this->sphereRadius = data.sphereRadius;
+	this->format = data.format;
+	this->cacheBefore = data.cacheBefore;
+	this->cacheAfter = data.cacheAfter;
+	this->overdrawBefore = data.overdrawBefore;
+	this->overdrawAfter = data.overdrawAfter;
+	this->verticesBeforeWeld = data.verticesBeforeWeld;
+	this->contentHash = data.contentHash;
+	this->lods = std::move(data.lods);
+	this->meshlets = std::move(data.meshlets);
+
+	const void* indexData = indexSize == 2
+		? static_cast<const void*>(this->shortIndices.data())
+		: static_cast<const void*>(this->indices.data());
+	setupMesh(this->vertices.data(), count, indexData, indexCount, donor);
+}
+
+Mesh::Mesh(
+	VertexFormat format,
+	const void* vertexData, size_t vertexCount,
+	const void* indexData, size_t indexCount, unsigned int indexSize,
+	std::vector<Texture> textures,
+	const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+	const glm::vec3& sphereCenter, float sphereRadius,
+	Mesh* donor
+)
+{
 	this->textures = textures;
+	this->boundsMin = boundsMin;
+	this->boundsMax = boundsMax;
+	this->sphereCenter = sphereCenter;
+	this->sphereRadius = sphereRadius;
+	this->format = format;
+	this->indexSize = indexSize;
 
-	setupMesh();
+	setupMesh(vertexData, vertexCount, indexData, indexCount, donor);
 }
 
-void Mesh::setupMesh()
+void Mesh::setupMesh(const void* vertexData, size_t vertexCount,
+	const void* indexData, size_t indexCount, Mesh* donor)
 {
+	this->indexCount = indexCount;
+	this->vertexCount = vertexCount;
+
+	//      GPU     :      
+	if (donor && donor->canDonateBuffers() && donor->format == format && donor->indexSize == indexSize
+		&& donor->vertexCount == vertexCount && donor->indexCount == indexCount)
+	{
+		std::swap(VAO, donor->VAO);
+		std::swap(VBO, donor->VBO);
+		std::swap(EBO, donor->EBO);
+		return;
+	}
+
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
 	glGenBuffers(1, &EBO);
@@ -24,38 +193,135 @@ void Mesh::setupMesh()
 	glBindVertexArray(VAO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, vertexCount * vertexSize(format), vertexData, GL_STATIC_DRAW);
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
-		&indices[0], GL_STATIC_DRAW);
-
-	// vertex positions
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-	// vertex normals
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
-	// vertex texture coords
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
-	// vertex tangent
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
-	// vertex bitangent
-	glEnableVertexAttribArray(4);
-	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
-	// ids
-	glEnableVertexAttribArray(5);
-	glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, m_BoneIDs));
-	// weights
-	glEnableVertexAttribArray(6);
-	glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, m_Weights));
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * indexSize,
+		indexData, GL_STATIC_DRAW);
+
+	setupVertexLayout(format);
 
 	glBindVertexArray(0);
 }
 
-void Mesh::Draw(Shader& shader)
+void Mesh::setupVertexLayout(VertexFormat format)
+{
+	//  VAO     
+	withVertexType(format, [](auto* tag)
+	{
+		setupVertexAttributes<typename std::remove_pointer<decltype(tag)>::type>();
+	});
+}
+
+void Mesh::releaseBuffers()
+{
+	if (!sharedBuffers && VAO != 0)
+	{
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &VBO);
+		glDeleteBuffers(1, &EBO);
+	}
+	VAO = VBO = EBO = 0;
+}
+
+void Mesh::attachSharedBuffers(unsigned int vao, int baseVertex, size_t indexOffset)
+{
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+	VBO = 0;
+	EBO = 0;
+
+	VAO = vao;
+	this->baseVertex = baseVertex;
+	this->indexOffset = indexOffset;
+	sharedBuffers = true;
+}
+
+const char* meshResidencyName(MeshResidency residency)
+{
+	switch (residency)
+	{
+	case MeshResidency::All:       return "all";
+	case MeshResidency::Positions: return "positions";
+	case MeshResidency::Bounds:    return "bounds";
+	}
+	return "unknown";
+}
+
+void Mesh::releaseGeometry(MeshResidency residency, const void* vertexData, const void* indexData)
+{
+	if (residency == MeshResidency::All)
+		return;
+
+	if (residency == MeshResidency::Positions)
+	{
+		//   ,  ,  ,   
+		const unsigned char* source = vertices.empty()
+			? static_cast<const unsigned char*>(vertexData)
+			: vertices.data();
+		if (source)
+		{
+			const size_t stride = vertexSize(format);
+			positions.resize(vertexCount);
+			for (size_t i = 0; i < vertexCount; ++i)
+			{
+				if (format == VertexFormat::Packed)
+					positions[i] = unpackPosition(*reinterpret_cast<const PackedVertex*>(source + i * stride),
+						boundsMin, boundsMax - boundsMin);
+				else
+					std::memcpy(&positions[i], source + i * stride, sizeof(glm::vec3));
+			}
+		}
+
+		//       ,     GPU
+		if (indices.empty() && shortIndices.empty() && indexData)
+		{
+			if (indexSize == 2)
+				shortIndices.assign(static_cast<const uint16_t*>(indexData), static_cast<const uint16_t*>(indexData) + indexCount);
+			else
+				indices.assign(static_cast<const unsigned int*>(indexData), static_cast<const unsigned int*>(indexData) + indexCount);
+		}
+	}
+	else
+	{
+		std::vector<unsigned int>().swap(indices);
+		std::vector<uint16_t>().swap(shortIndices);
+	}
+
+	// clear()         
+	std::vector<unsigned char>().swap(vertices);
+}
+
+size_t Mesh::getCpuBytes() const
+{
+	size_t bytes = sizeof(Mesh)
+		+ vertices.capacity()
+		+ indices.capacity() * sizeof(unsigned int)
+		+ shortIndices.capacity() * sizeof(uint16_t)
+		+ positions.capacity() * sizeof(glm::vec3)
+		+ lods.capacity() * sizeof(MeshLod)
+		+ meshlets.capacity() * sizeof(Meshlet)
+		+ rangeOffsets.capacity() * sizeof(const void*)
+		+ rangeCounts.capacity() * sizeof(int)
+		+ rangeBaseVertices.capacity() * sizeof(int)
+		+ textures.capacity() * sizeof(Texture)
+		+ info.capacity();
+	for (const Texture& texture : textures)
+		bytes += texture.type.capacity() + texture.path.capacity();
+	return bytes;
+}
+
+void Mesh::Draw(Shader& shader, unsigned int lod, const IndexRanges* ranges)
+{
+	bindTextures(shader);
+	setVertexDecoding(shader);
+
+	// draw mesh
+	drawLod(lod, ranges);
+}
+
+void Mesh::bindTextures(Shader& shader) const
 {
 	unsigned int diffuseNr = 1;
 	unsigned int specularNr = 1;
@@ -81,22 +347,93 @@ void Mesh::Draw(Shader& shader)
 		glBindTexture(GL_TEXTURE_2D, textures[i].id);
 	}
 
-	// draw mesh
-	glBindVertexArray(VAO);
-	glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
-	glBindVertexArray(0);
-
 	glActiveTexture(GL_TEXTURE0);
 }
 
-void Mesh::DrawForPicking(Shader& shader, const glm::vec3& color)
+void Mesh::DrawInstanced(Shader& shader, unsigned int lod, unsigned int instanceCount, bool picking)
+{
+	if (!picking)
+		bindTextures(shader);
+	setVertexDecoding(shader);
+
+	drawLod(lod, nullptr, instanceCount);
+}
+
+void Mesh::DrawForPicking(Shader& shader, const glm::vec3& color, unsigned int lod, const IndexRanges* ranges)
 {
 	shader.use(); //  
 	shader.setVec3("objectColor", color); //     
+	setVertexDecoding(shader);
 
-	glBindVertexArray(VAO);
-	glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
-	glBindVertexArray(0);
+	drawLod(lod, ranges);
+}
+
+MeshLod Mesh::getLod(unsigned int lod) const
+{
+	if (lods.empty())
+	{
+		MeshLod full;
+		full.indexCount = static_cast<uint32_t>(indexCount);
+		return full;
+	}
+	return lods[std::min<size_t>(lod, lods.size() - 1)];
 }
 
+void Mesh::drawLod(unsigned int lod, const IndexRanges* ranges, unsigned int instanceCount)
+{
+	//  VAO   Model       
+	if (!sharedBuffers)
+		glBindVertexArray(VAO);
+
+	if (ranges)
+	{
+		//     
+		rangeOffsets.resize(ranges->firstIndices.size());
+		rangeCounts.resize(ranges->indexCounts.size());
+		rangeBaseVertices.assign(ranges->firstIndices.size(), baseVertex);
+		for (size_t i = 0; i < rangeOffsets.size(); ++i)
+		{
+			rangeOffsets[i] = reinterpret_cast<const void*>(indexOffset + static_cast<size_t>(ranges->firstIndices[i]) * indexSize);
+			rangeCounts[i] = static_cast<int>(ranges->indexCounts[i]);
+		}
+		if (!rangeOffsets.empty())
+			glMultiDrawElementsBaseVertex(GL_TRIANGLES, rangeCounts.data(), glIndexType(), rangeOffsets.data(),
+				static_cast<GLsizei>(rangeOffsets.size()), rangeBaseVertices.data());
+	}
+	else
+	{
+		//     EBO :   
+		MeshLod range = getLod(lod);
+		const void* offset = reinterpret_cast<const void*>(indexOffset + static_cast<size_t>(range.firstIndex) * indexSize);
+		if (instanceCount > 1)
+			glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), glIndexType(),
+				offset, static_cast<GLsizei>(instanceCount), baseVertex);
+		else
+			glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), glIndexType(), offset, baseVertex);
+	}
 
+	if (!sharedBuffers)
+		glBindVertexArray(0);
+}
+
+void Mesh::setVertexDecoding(Shader& shader) const
+{
+	shader.setVec3("positionOffset", getPositionOffset());
+	shader.setVec3("positionScale", getPositionScale());
+	shader.setBool("octNormals", format == VertexFormat::Packed);
+}
+
+glm::vec3 Mesh::getPositionOffset() const
+{
+	return format == VertexFormat::Packed ? boundsMin : glm::vec3(0.0f);
+}
+
+glm::vec3 Mesh::getPositionScale() const
+{
+	return format == VertexFormat::Packed ? boundsMax - boundsMin : glm::vec3(1.0f);
+}
+
+unsigned int Mesh::glIndexType() const
+{
+	return indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
@@ -1,22 +1,15 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <vector>
 #include <string>
-
-#define MAX_BONE_INFLUENCE 4
+#include "VertexFormat.h"
+#include "Meshlet.h"
 
 class Shader;
 
-struct Vertex {
-	glm::vec3 Position;
-	glm::vec3 Normal;
-	glm::vec2 TexCoords;
-	glm::vec3 Tangent;
-	glm::vec3 Bitangent;
-
-	int m_BoneIDs[MAX_BONE_INFLUENCE];
-	float m_Weights[MAX_BONE_INFLUENCE];
-};
+// ,      ,  16- 
+const size_t MAX_SHORT_INDEX_VERTICES = 65536;
 
 struct Texture {
 	unsigned int id;
@@ -24,13 +17,138 @@ struct Texture {
 	std::string path;
 };
 
+//    ,     GPU
+struct TextureRef {
+	std::string type;
+	std::string path;
+};
+
+//      (. MeshOptimizer.h)
+struct VertexCacheStats {
+	float acmr = 0.0f; //    : 0.5  , 3    
+	float atvr = 0.0f; //   : 1      
+};
+
+//    ,  
+const unsigned int MAX_MESH_LODS = 4;
+
+//        .
+//         .      .
+struct MeshLod {
+	uint32_t firstIndex = 0;
+	uint32_t indexCount = 0;
+	float error = 0.0f; //      ;    0
+};
+
+//     CPU.       GL,
+//  GPU        Mesh.
+struct MeshData {
+	VertexFormat				format = VertexFormat::Full;
+	std::vector<unsigned char>	vertices; //   format ,   ,     GPU
+	std::vector<unsigned int>	indices;
+	std::vector<uint16_t>		shortIndices; //  compactIndices(): 16- , indices 
+	std::vector<TextureRef>		textures;
+
+	glm::vec3 color = glm::vec3(1.0f); //   
+	glm::vec3 boundsMin = glm::vec3(0.0f);
+	glm::vec3 boundsMax = glm::vec3(0.0f);
+	glm::vec3 sphereCenter = glm::vec3(0.0f); //   (computeBounds):  AABB
+	float sphereRadius = 0.0f;
+
+	VertexCacheStats cacheBefore; //    
+	VertexCacheStats cacheAfter;  //  optimizeMesh (    ,  cacheBefore)
+	float overdrawBefore = 0.0f;  //   (analyzeOverdraw); 0   
+	float overdrawAfter = 0.0f;
+	size_t verticesBeforeWeld = 0; //   weldVertices; 0    
+	uint64_t contentHash = 0;      // computeContentHash()  ; 0   
+
+	//  generateLods:  0   ,       indices.
+	//       .
+	std::vector<MeshLod> lods;
+
+	//      (buildMeshlets);     
+	std::vector<Meshlet> meshlets;
+
+	size_t vertexCount() const { return vertices.size() / vertexSize(format); }
+
+	//    ,     GPU: 2  4   
+	unsigned int indexSize() const { return shortIndices.empty() ? 4 : 2; }
+	size_t indexCount() const { return shortIndices.empty() ? indices.size() : shortIndices.size(); }
+	const void* indexData() const;
+
+	//  ,    GPU: ,     .   
+	//             
+	uint64_t computeContentHash() const;
+
+	//    16 ,     MAX_SHORT_INDEX_VERTICES.
+	//   :       32-.
+	bool compactIndices();
+
+	//     V; V   format
+	template <class V> V* vertexArray() { return reinterpret_cast<V*>(vertices.data()); }
+	template <class V> const V* vertexArray() const { return reinterpret_cast<const V*>(vertices.data()); }
+
+	//   i     
+	const glm::vec3& position(size_t i) const
+	{
+		return *reinterpret_cast<const glm::vec3*>(vertices.data() + i * vertexSize(format));
+	}
+};
+
+//  :  meshes[mesh]   node SceneGraph .
+// ,      (  ),   GPU
+//  ,    .      .
+struct MeshInstance {
+	uint32_t mesh = 0;
+	uint32_t node = 0;
+};
+
+//      CPU    GPU (Mesh::releaseGeometry)
+enum class MeshResidency {
+	All,       //    ,   
+	Positions, //  (, vec3)        CPU
+	Bounds,    //  ,    
+};
+
+//    
+const char* meshResidencyName(MeshResidency residency);
+
 class Mesh {
 	public:
 		// mesh data
-		std::vector<Vertex>			vertices;
+		std::vector<unsigned char>	vertices; //   getVertexFormat()
 		std::vector<unsigned int>	indices;
+		std::vector<uint16_t>		shortIndices; // 16-  (indices  )
+		std::vector<glm::vec3>		positions; //  releaseGeometry(Positions),   
 		std::vector<Texture>		textures;
 
+		//     
+		glm::vec3 boundsMin = glm::vec3(0.0f);
+		glm::vec3 boundsMax = glm::vec3(0.0f);
+		//      LOD    
+		glm::vec3 sphereCenter = glm::vec3(0.0f);
+		float sphereRadius = 0.0f;
+
+		// ACMR/ATVR        
+		VertexCacheStats cacheBefore;
+		VertexCacheStats cacheAfter;
+
+		//       ; 0   
+		float overdrawBefore = 0.0f;
+		float overdrawAfter = 0.0f;
+
+		//     ; 0    
+		size_t verticesBeforeWeld = 0;
+
+		// MeshData::computeContentHash  ;       
+		uint64_t contentHash = 0;
+
+		//    EBO;       EBO
+		std::vector<MeshLod> lods;
+
+		//       CPU
+		std::vector<Meshlet> meshlets;
+
 		//   
 		void setInfo(const std::string& text) { info = text; }
 
@@ -41,20 +159,102 @@ class Mesh {
 			std::vector<unsigned int> indices,
 			std::vector<Texture> textures
 		);
-		
-		void Draw(Shader& shader);
-		void DrawForPicking(Shader& shader, const glm::vec3& color);
 
-		int pickingID;
+		//    CPU-:    ,  .
+		// donor          (contentHash ):  
+		// GPU       ,  donor  
+		Mesh(MeshData&& data, std::vector<Texture> textures, Mesh* donor = nullptr);
+
+		//     (,   ):
+		//     GPU, CPU-     
+		Mesh(
+			VertexFormat format,
+			const void* vertexData, size_t vertexCount,
+			const void* indexData, size_t indexCount, unsigned int indexSize,
+			std::vector<Texture> textures,
+			const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+			const glm::vec3& sphereCenter, float sphereRadius,
+			Mesh* donor = nullptr
+		);
+
+		size_t getIndexCount() const { return indexCount; } //   
+		unsigned int getLodCount() const { return lods.empty() ? 1u : static_cast<unsigned int>(lods.size()); }
+		MeshLod getLod(unsigned int lod) const;
+		unsigned int getIndexSize() const { return indexSize; } // 2  4 
+		size_t getVertexCount() const { return vertexCount; }
+		VertexFormat getVertexFormat() const { return format; }
+		//    GPU, 
+		size_t getVertexBytes() const { return vertexCount * vertexSize(format); }
+
+		// ranges       ; nullptr    lod
+		//       (SharedGeometry); 0  attachSharedBuffers
+		unsigned int getVertexBuffer() const { return VBO; }
+		unsigned int getIndexBuffer() const { return EBO; }
+
+		//      :  VAO/VBO/EBO , 
+		//   baseVertex,     indexOffset .
+		//        VAO (  Model).
+		void attachSharedBuffers(unsigned int vao, int baseVertex, size_t indexOffset);
+		//   VAO/VBO/EBO (   ).    vector ,
+		//     ,   .    GL
+		void releaseBuffers();
+		//            
+		bool canDonateBuffers() const { return VAO != 0 && !sharedBuffers; }
+		bool usesSharedBuffers() const { return sharedBuffers; }
+		unsigned int getVAO() const { return VAO; }
+		int getBaseVertex() const { return baseVertex; }
+		//      EBO,   (   4 )
+		uint32_t getFirstIndex() const { return static_cast<uint32_t>(indexOffset / indexSize); }
+		unsigned int glIndexType() const;
+
+		//  CPU- ,    GPU; . MeshResidency.
+		// vertexData  indexData    :    
+		//  Positions,     (   ).
+		void releaseGeometry(MeshResidency residency, const void* vertexData = nullptr, const void* indexData = nullptr);
+		//  CPU,   : , LOD, ,    
+		size_t getCpuBytes() const;
+
+		//    format   VAO  GL_ARRAY_BUFFER
+		static void setupVertexLayout(VertexFormat format);
+
+		void Draw(Shader& shader, unsigned int lod = 0, const IndexRanges* ranges = nullptr);
+		//     sampler- ; Draw   
+		void bindTextures(Shader& shader) const;
+		//       
+		void setVertexDecoding(Shader& shader) const;
+		//      DrawData:   
+		glm::vec3 getPositionOffset() const;
+		glm::vec3 getPositionScale() const;
+		void DrawForPicking(Shader& shader, const glm::vec3& color, unsigned int lod = 0,
+			const IndexRanges* ranges = nullptr);
+		//  lod , instanceCount   . ,    picking
+		//     drawData  instanceBase + gl_InstanceID    Model
+		void DrawInstanced(Shader& shader, unsigned int lod, unsigned int instanceCount, bool picking = false);
 
 	private:
 		// render data
 		unsigned int VAO = 0;
 		unsigned int VBO = 0;
 		unsigned int EBO = 0;
+		size_t indexCount = 0; //    EBO
+		unsigned int indexSize = 4; // GL_UNSIGNED_SHORT  GL_UNSIGNED_INT
+		size_t vertexCount = 0;
+		VertexFormat format = VertexFormat::Full;
+
+		//   
+		bool sharedBuffers = false;
+		int baseVertex = 0;
+		size_t indexOffset = 0; //     EBO
 
 		std::string info;
 
-		void setupMesh();
+		void setupMesh(const void* vertexData, size_t vertexCount,
+			const void* indexData, size_t indexCount, Mesh* donor = nullptr);
+		void drawLod(unsigned int lod, const IndexRanges* ranges, unsigned int instanceCount = 1);
+
+		//      glMultiDrawElements,     
+		std::vector<const void*> rangeOffsets;
+		std::vector<int> rangeCounts;
+		std::vector<int> rangeBaseVertices;
 };
 
@@ -1,261 +1,2100 @@
 #include "Model.h"
+#include "AllocationCounter.h"
+#include "Bounds.h"
+#include "GltfLoader.h"
+#include "Hash.h"
+#include "IndirectDraw.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjLoader.h"
+#include "ProcessMemory.h"
+#include "ScratchArena.h"
+#include "SharedGeometry.h"
+#include "TextureRegistry.h"
+#include "ThreadPool.h"
 #include <assimp/Importer.hpp>
+#include <assimp/config.h>
 #include <assimp/postprocess.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
-#include <stb_image.h>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+
+namespace
+{
+    double msBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return msBetween(start, std::chrono::steady_clock::now());
+    }
+
+    //     IndirectDraw:      0
+    const unsigned int DRAW_DATA_UNIT = 15;
+
+    //         
+    const size_t WELD_REPORT_MESHES = 16;
+
+    // ID  24    picking:   + 1, 0  
+    glm::vec3 pickingColor(uint32_t id)
+    {
+        return glm::vec3(
+            (id & 0xFF) / 255.0f,
+            ((id >> 8) & 0xFF) / 255.0f,
+            ((id >> 16) & 0xFF) / 255.0f
+        );
+    }
+
+    size_t countTriangles(const Mesh& mesh, unsigned int lod, const IndexRanges* ranges)
+    {
+        if (!ranges)
+            return mesh.getLod(lod).indexCount / 3;
+
+        size_t triangles = 0;
+        for (uint32_t count : ranges->indexCounts)
+            triangles += count / 3;
+        return triangles;
+    }
+
+    //            
+    float maxAxisScale(const glm::mat4& m)
+    {
+        float scale2 = std::max(std::max(glm::dot(glm::vec3(m[0]), glm::vec3(m[0])), glm::dot(glm::vec3(m[1]), glm::vec3(m[1]))),
+            glm::dot(glm::vec3(m[2]), glm::vec3(m[2])));
+        return std::sqrt(scale2);
+    }
+
+    //    ,     VAO,     
+    bool sameBatch(const Mesh& a, const Mesh& b)
+    {
+        if (a.getVAO() != b.getVAO() || a.getIndexSize() != b.getIndexSize() || a.textures.size() != b.textures.size())
+            return false;
+        for (size_t t = 0; t < a.textures.size(); ++t)
+        {
+            if (a.textures[t].id != b.textures[t].id)
+                return false;
+        }
+        return true;
+    }
+}
 
 void Model::Draw(Shader & shader)
 {
-    //  
-    shader.use();
+    auto submitStart = std::chrono::steady_clock::now();
+
+    //  
+    shader.use();
+
+    // 2.   
+    glm::mat4 modelMat = getModelMatrix();
+
+    // 3.   
+    shader.setMat4("model", modelMat);
+    // samplerBuffer        sampler2D ,   IndirectDraw
+    shader.setInt("drawData", DRAW_DATA_UNIT);
+
+    drawnTriangles = 0;
+    fullTriangles = 0;
+    clusterStats = ClusterStats();
+    updateSceneGraph();
+
+    const glm::mat4 modelView = viewMatrix * modelMat;
+    const ClusterCuller culler(projectionMatrix * modelView, modelView, clusterBackfaceCulling);
+
+    //    ;   
+    if (meshColors.size() < meshes.size())
+        meshColors.resize(meshes.size(), glm::vec3(1.0f));
+
+    if (usesIndirectDraw())
+        drawIndirect(shader, culler, false, clusterStats);
+    else
+        drawInstances(shader, culler, false, clusterStats);
+
+    // ,          
+    const double submitMs = elapsedMs(submitStart);
+    drawSubmitMs = drawSubmitMs == 0.0 ? submitMs : drawSubmitMs * 0.95 + submitMs * 0.05;
+}
+
+bool Model::usesIndirectDraw() const
+{
+    return indirectEnabled && indirectDraw && IndirectDraw::isSupported();
+}
+
+void Model::collectInstances(const ClusterCuller& culler, bool allRecords)
+{
+    const glm::mat4 modelMat = getModelMatrix();
+    instanceBatches.clear();
+    drawData.clear();
+
+    //        ;   
+    //      cullClusters
+    const bool cullInstances = clusterCulling && viewportHeight > 0.0f;
+
+    //    drawOrder:      VAO    
+    for (size_t n = 0; n < meshes.size(); ++n)
+    {
+        const size_t i = sharedGeometry ? drawOrder[n] : n;
+        const Mesh& mesh = meshes[i];
+
+        frameInstances.clear();
+        for (uint32_t k = meshInstanceStart[i]; k < meshInstanceStart[i + 1]; ++k)
+        {
+            if (instanceVisible[meshInstanceList[k]])
+                frameInstances.push_back({ meshInstanceList[k], 0u });
+        }
+
+        const bool several = frameInstances.size() > 1;
+        unsigned int lodCounts[MAX_MESH_LODS] = {};
+        size_t visible = 0;
+        for (size_t v = 0; v < frameInstances.size(); ++v)
+        {
+            const uint32_t instance = frameInstances[v].first;
+            const glm::mat4& world = sceneGraph.getWorld(instances[instance].node);
+            if (several && cullInstances &&
+                !culler.isVisible(glm::vec3(world * glm::vec4(mesh.sphereCenter, 1.0f)), mesh.sphereRadius * maxAxisScale(world)))
+                continue;
+
+            const unsigned int lod = selectLod(mesh, modelMat * world);
+            ++lodCounts[lod];
+            frameInstances[visible++] = { instance, lod };
+        }
+        frameInstances.resize(visible);
+
+        //    LOD,        
+        for (unsigned int lod = 0; lod < mesh.getLodCount(); ++lod)
+        {
+            if (!lodCounts[lod])
+                continue;
+
+            InstanceBatch batch = { static_cast<uint32_t>(i), lod, 0, static_cast<uint32_t>(drawData.size()), lodCounts[lod] };
+            bool first = true;
+            for (const auto& entry : frameInstances)
+            {
+                if (entry.second != lod)
+                    continue;
+                if (first)
+                    batch.instance = entry.first;
+                first = false;
+                if (!allRecords && batch.count == 1)
+                    continue;
+
+                DrawData data;
+                data.color = glm::vec4(meshColors[i], 1.0f);
+                data.pickingColor = glm::vec4(pickingColor(entry.first + 1), 1.0f);
+                data.positionOffset = glm::vec4(mesh.getPositionOffset(), 0.0f);
+                data.positionScale = glm::vec4(mesh.getPositionScale(), 0.0f);
+                data.node = sceneGraph.getWorld(instances[entry.first].node);
+                drawData.push_back(data);
+            }
+            instanceBatches.push_back(batch);
+        }
+    }
+}
+
+void Model::drawInstances(Shader& shader, const ClusterCuller& culler, bool picking, ClusterStats& stats)
+{
+    const glm::mat4 modelView = viewMatrix * getModelMatrix();
+
+    collectInstances(culler, false);
+    if (!drawData.empty())
+        drawDataBuffer.upload(drawData, DRAW_DATA_UNIT);
+
+    //        ,  VAO    
+    unsigned int boundVAO = 0;
+    uint32_t boundNode = SceneGraph::NO_PARENT;
+    bool instanced = false; //  instanceBase
+    if (!picking)
+        drawCalls = 0;
+
+    for (const InstanceBatch& batch : instanceBatches)
+    {
+        Mesh& mesh = meshes[batch.mesh];
+
+        if (mesh.usesSharedBuffers() && mesh.getVAO() != boundVAO)
+        {
+            boundVAO = mesh.getVAO();
+            glBindVertexArray(boundVAO);
+        }
+
+        //     ,  
+        if (!picking && mesh.textures.empty())
+            shader.setVec3("objectColor", meshColors[batch.mesh]);
+
+        if (batch.count > 1)
+        {
+            //    :    picking      drawData
+            shader.setInt("instanceBase", static_cast<int>(batch.firstRecord));
+            instanced = true;
+            mesh.DrawInstanced(shader, batch.lod, batch.count, picking);
+            if (!picking)
+            {
+                drawnTriangles += batch.count * countTriangles(mesh, batch.lod, nullptr);
+                fullTriangles += batch.count * (mesh.getLod(0).indexCount / 3);
+            }
+        }
+        else
+        {
+            if (instanced)
+            {
+                shader.setInt("instanceBase", -1);
+                instanced = false;
+            }
+
+            //        
+            const uint32_t node = instances[batch.instance].node;
+            if (node != boundNode)
+            {
+                boundNode = node;
+                shader.setMat4("node", sceneGraph.getWorld(node));
+            }
+
+            const IndexRanges* ranges = cullClusters(mesh, node, batch.lod, culler, modelView, stats);
+            if (picking)
+            {
+                mesh.DrawForPicking(shader, pickingColor(batch.instance + 1), batch.lod, ranges);
+            }
+            else
+            {
+                drawnTriangles += countTriangles(mesh, batch.lod, ranges);
+                fullTriangles += mesh.getLod(0).indexCount / 3;
+                mesh.Draw(shader, batch.lod, ranges);
+            }
+        }
+
+        if (!picking)
+            ++drawCalls;
+    }
+
+    if (instanced)
+        shader.setInt("instanceBase", -1);
+    if (boundVAO)
+        glBindVertexArray(0);
+}
+
+void Model::drawIndirect(Shader& shader, const ClusterCuller& culler, bool picking, ClusterStats& stats)
+{
+    const glm::mat4 modelView = viewMatrix * getModelMatrix();
+
+    collectInstances(culler, true);
+    indirectDraw->clear();
+    drawBatches.clear();
+
+    //    :   VAO    
+    for (const InstanceBatch& batch : instanceBatches)
+    {
+        const Mesh& mesh = meshes[batch.mesh];
+        const unsigned int lod = batch.lod;
+
+        if (drawBatches.empty() || !sameBatch(meshes[drawBatches.back().firstMesh], mesh))
+        {
+            if (!drawBatches.empty())
+                drawBatches.back().commandCount = indirectDraw->getCommandCount() - drawBatches.back().firstCommand;
+            drawBatches.push_back({ batch.mesh, indirectDraw->getCommandCount(), 0 });
+        }
+
+        //      :      
+        const IndexRanges* ranges = batch.count == 1
+            ? cullClusters(mesh, instances[batch.instance].node, lod, culler, modelView, stats) : nullptr;
+
+        // baseInstance      drawData,      draw ID;
+        //     
+        DrawElementsIndirectCommand command = { 0, batch.count, 0, mesh.getBaseVertex(), batch.firstRecord };
+        if (ranges)
+        {
+            for (size_t r = 0; r < ranges->firstIndices.size(); ++r)
+            {
+                command.count = ranges->indexCounts[r];
+                command.firstIndex = mesh.getFirstIndex() + ranges->firstIndices[r];
+                indirectDraw->addCommand(command);
+            }
+        }
+        else
+        {
+            MeshLod range = mesh.getLod(lod);
+            command.count = range.indexCount;
+            command.firstIndex = mesh.getFirstIndex() + range.firstIndex;
+            indirectDraw->addCommand(command);
+        }
+
+        if (!picking)
+        {
+            drawnTriangles += batch.count * countTriangles(mesh, lod, ranges);
+            fullTriangles += batch.count * (mesh.getLod(0).indexCount / 3);
+        }
+    }
+    if (!drawBatches.empty())
+        drawBatches.back().commandCount = indirectDraw->getCommandCount() - drawBatches.back().firstCommand;
+
+    indirectDraw->upload();
+    drawDataBuffer.upload(drawData, DRAW_DATA_UNIT);
+    shader.setBool("useDrawData", true);
+
+    unsigned int boundVAO = 0;
+    for (const DrawBatch& batch : drawBatches)
+    {
+        const Mesh& mesh = meshes[batch.firstMesh];
+        if (mesh.getVAO() != boundVAO)
+        {
+            boundVAO = mesh.getVAO();
+            glBindVertexArray(boundVAO);
+        }
+
+        if (!picking)
+            mesh.bindTextures(shader);
+        mesh.setVertexDecoding(shader); // octNormals    ,     drawData
+        indirectDraw->draw(mesh.glIndexType(), batch.firstCommand, batch.commandCount);
+    }
+
+    glBindVertexArray(0);
+    shader.setBool("useDrawData", false);
+
+    if (!picking)
+        drawCalls = drawBatches.size();
+}
+
+DrawBenchmark Model::benchmarkDraw(Shader& shader, unsigned int frames)
+{
+    DrawBenchmark result;
+    result.sharedBuffers = sharedGeometry != nullptr;
+    result.indirect = usesIndirectDraw();
+    result.frames = frames ? frames : 1;
+
+    //   GPU     
+    glFinish();
+
+    const double averageBefore = drawSubmitMs;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int f = 0; f < result.frames; ++f)
+        Draw(shader);
+    result.submitMs = elapsedMs(start) / result.frames;
+
+    glFinish();
+    result.finishMs = elapsedMs(start) / result.frames;
+    drawSubmitMs = averageBefore;
+
+    std::cout << "Draw benchmark (" << (result.sharedBuffers ? "shared buffers" : "per-mesh buffers")
+        << (result.indirect ? ", indirect" : "") << ", " << meshes.size() << " meshes, " << instances.size()
+        << " instances, " << drawCalls << " draw calls, " << result.frames << " frames): submit " << result.submitMs
+        << " ms, with GPU " << result.finishMs << " ms per Draw" << std::endl;
+    return result;
+}
+
+IndirectDrawCheck Model::compareIndirectDraw(Shader& shader, Shader& pickingShader, int width, int height)
+{
+    IndirectDrawCheck result;
+    result.supported = indirectDraw && IndirectDraw::isSupported();
+    result.width = width;
+    result.height = height;
+    if (!result.supported || width <= 0 || height <= 0)
+    {
+        std::cout << "Indirect draw check: multi-draw indirect or shared buffers not available" << std::endl;
+        return result;
+    }
+
+    GLint previousFramebuffer = 0;
+    GLint viewport[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    //   :       ,       
+    unsigned int framebuffer, colorBuffer, depthBuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &colorBuffer);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    glViewport(0, 0, width, height);
+
+    const bool indirectBefore = indirectEnabled;
+    const bool pickingBefore = pickingEnabled;
+    pickingEnabled = true;
+
+    auto render = [&](bool indirect, bool picking)
+    {
+        indirectEnabled = indirect;
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        if (picking)
+        {
+            pickingShader.use();
+            pickingShader.setMat4("model", getModelMatrix());
+            drawForPicking(pickingShader);
+        }
+        else
+        {
+            Draw(shader);
+            (indirect ? result.indirectDrawCalls : result.loopDrawCalls) = drawCalls;
+        }
+
+        std::vector<unsigned char> pixels(size_t(width) * height * 4);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        return pixels;
+    };
+    auto mismatches = [](const std::vector<unsigned char>& a, const std::vector<unsigned char>& b)
+    {
+        size_t count = 0;
+        for (size_t p = 0; p < a.size(); p += 4)
+            count += std::memcmp(&a[p], &b[p], 4) != 0;
+        return count;
+    };
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+    {
+        result.colorMismatches = mismatches(render(false, false), render(true, false));
+        result.pickingMismatches = mismatches(render(false, true), render(true, true));
+    }
+    else
+    {
+        std::cerr << "ERROR::FRAMEBUFFER::Indirect draw check FBO is not complete" << std::endl;
+        result.supported = false;
+    }
+
+    indirectEnabled = indirectBefore;
+    pickingEnabled = pickingBefore;
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+
+    std::cout << "Indirect draw check (" << width << "x" << height << ", " << result.loopDrawCalls << " -> "
+        << result.indirectDrawCalls << " draw calls): " << result.colorMismatches << " color and "
+        << result.pickingMismatches << " picking pixels differ" << (result.passed() ? "" : " - FAILED") << std::endl;
+    return result;
+}
+
+void Model::buildSharedGeometry()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    auto geometry = std::make_unique<SharedGeometry>();
+    if (!geometry->build(meshes, instances.size()))
+        return;
+
+    //    VAO,          IndirectDraw;
+    //      
+    drawOrder.resize(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+        drawOrder[i] = i;
+    std::stable_sort(drawOrder.begin(), drawOrder.end(), [this](size_t l, size_t r)
+    {
+        const Mesh& a = meshes[l];
+        const Mesh& b = meshes[r];
+        if (a.getVAO() != b.getVAO())
+            return a.getVAO() < b.getVAO();
+        if (a.getIndexSize() != b.getIndexSize())
+            return a.getIndexSize() < b.getIndexSize();
+        unsigned int textureA = a.textures.empty() ? 0 : a.textures[0].id;
+        unsigned int textureB = b.textures.empty() ? 0 : b.textures[0].id;
+        return textureA < textureB;
+    });
+
+    sharedGeometry = std::move(geometry);
+    if (IndirectDraw::isSupported())
+        indirectDraw = std::make_unique<IndirectDraw>();
+    std::cout << "  shared buffers: " << meshes.size() << " meshes in " << sharedGeometry->getVAOCount()
+        << " VAO(s), " << (sharedGeometry->getVertexBytes() + sharedGeometry->getIndexBytes()) / 1024
+        << " KB, built in " << elapsedMs(start) << " ms" << std::endl;
+}
+
+const IndexRanges* Model::cullClusters(const Mesh& mesh, uint32_t node, unsigned int lod,
+    const ClusterCuller& modelCuller, const glm::mat4& modelView, ClusterStats& stats)
+{
+    //     ;     
+    if (!clusterCulling || lod != 0 || mesh.meshlets.empty() || viewportHeight <= 0.0f)
+        return nullptr;
+
+    //      :      
+    const glm::mat4& world = sceneGraph.getWorld(node);
+    if (world != glm::mat4(1.0f) && nodeCullerNode != node)
+    {
+        const glm::mat4 meshView = modelView * world;
+        nodeCuller.emplace(projectionMatrix * meshView, meshView, clusterBackfaceCulling);
+        nodeCullerNode = node;
+    }
+    const ClusterCuller& culler = world == glm::mat4(1.0f) ? modelCuller : *nodeCuller;
+
+    //          
+    if (!culler.isVisible(mesh.sphereCenter, mesh.sphereRadius))
+    {
+        visibleRanges.clear();
+        stats.tested += mesh.meshlets.size();
+        stats.frustumCulled += mesh.meshlets.size();
+        return &visibleRanges;
+    }
+
+    culler.cull(mesh.meshlets.data(), mesh.meshlets.size(), visibleRanges, stats);
+    return &visibleRanges;
+}
+
+void Model::updateSceneGraph()
+{
+    auto start = std::chrono::steady_clock::now();
+    nodesUpdated = sceneGraph.update();
+    sceneUpdateMs = elapsedMs(start);
+
+    //        
+    nodeCullerNode = SceneGraph::NO_PARENT;
+}
+
+glm::mat4 Model::getModelMatrix() const
+{
+    glm::mat4 modelMat = glm::mat4(1.0f);
+    modelMat = glm::translate(modelMat, position);
+    modelMat = modelMat * rotationMatrix;
+    modelMat = glm::scale(modelMat, glm::vec3(scale)); //  scale
+    return modelMat;
+}
+
+void Model::setCamera(const glm::mat4& view, const glm::mat4& projection, float height)
+{
+    viewMatrix = view;
+    projectionMatrix = projection;
+    viewportHeight = height;
+}
+
+unsigned int Model::selectLod(const Mesh& mesh, const glm::mat4& meshMatrix) const
+{
+    const unsigned int lodCount = mesh.getLodCount();
+    if (lodCount == 1 || lodThreshold <= 0.0f || viewportHeight <= 0.0f)
+        return 0;
+
+    //         ;      
+    const float meshScale = maxAxisScale(meshMatrix);
+    float radius = mesh.sphereRadius * meshScale;
+    glm::vec4 viewCenter = viewMatrix * meshMatrix * glm::vec4(mesh.sphereCenter, 1.0f);
+    float distance = -viewCenter.z - radius;
+    if (distance <= 0.0f)
+        return 0; //        
+
+    //       : projection[1][1] = 1 / tan(fovy / 2)
+    float pixelsPerUnit = projectionMatrix[1][1] * viewportHeight * 0.5f / distance;
+
+    for (unsigned int lod = lodCount - 1; lod > 0; --lod)
+    {
+        if (mesh.getLod(lod).error * meshScale * pixelsPerUnit <= lodThreshold)
+            return lod;
+    }
+    return 0;
+}
+
+namespace
+{
+    //  Assimp,     ,   compareLoaders
+    const unsigned int IMPORT_FLAGS =
+        aiProcess_Triangulate |
+        aiProcess_FlipUVs |
+        aiProcess_CalcTangentSpace;
+
+    //  Assimp     :    
+    // ApplyPostProcessing,   .         
+    struct AssimpStep {
+        unsigned int flag;
+        const char* name;
+    };
+    const AssimpStep ASSIMP_STEPS[] = {
+        { aiProcess_ValidateDataStructure, "Assimp: validate data structure" },
+        { aiProcess_FlipUVs, "Assimp: flip UVs" },
+        { aiProcess_RemoveRedundantMaterials, "Assimp: remove redundant materials" },
+        { aiProcess_FindDegenerates, "Assimp: find degenerates" },
+        { aiProcess_Triangulate, "Assimp: triangulate" },
+        { aiProcess_SortByPType, "Assimp: sort by primitive type" },
+        { aiProcess_FindInvalidData, "Assimp: find invalid data" },
+        { aiProcess_OptimizeMeshes, "Assimp: optimize meshes" },
+        { aiProcess_GenSmoothNormals, "Assimp: generate smooth normals" },
+        { aiProcess_CalcTangentSpace, "Assimp: calculate tangent space" },
+        { aiProcess_JoinIdenticalVertices, "Assimp: join identical vertices" },
+        { aiProcess_ImproveCacheLocality, "Assimp: improve cache locality" },
+    };
+
+    //    ;     
+    enum ConvertStep {
+        CONVERT_FILL,
+        CONVERT_WELD,
+        CONVERT_VERTEX_CACHE,
+        CONVERT_OVERDRAW,
+        CONVERT_MESHLETS,
+        CONVERT_LODS,
+        CONVERT_PACK,
+        CONVERT_STEP_COUNT
+    };
+    const char* const CONVERT_STEP_NAMES[CONVERT_STEP_COUNT] = {
+        "Convert aiMesh", "Weld vertices", "Vertex cache", "Overdraw", "Meshlets", "LODs", "Pack vertices"
+    };
+
+    bool isCancelled(const ImportProgress* progress)
+    {
+        return progress && progress->cancel;
+    }
+
+    //  ,    ,    ; instance.mesh
+    //    aiScene    .    
+    //     GPU  
+    std::vector<const aiMesh*> referencedMeshes(const aiScene* scene, std::vector<MeshInstance>& instances)
+    {
+        const uint32_t none = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> remap(scene->mNumMeshes, none);
+        std::vector<const aiMesh*> meshes;
+        for (MeshInstance& instance : instances)
+        {
+            uint32_t& mesh = remap[instance.mesh];
+            if (mesh == none)
+            {
+                mesh = static_cast<uint32_t>(meshes.size());
+                meshes.push_back(scene->mMeshes[instance.mesh]);
+            }
+            instance.mesh = mesh;
+        }
+        return meshes;
+    }
+
+    //  ,    processMesh   data: , ,
+    //      TextureRef    std::string.
+    //       
+    size_t expectedProcessMeshAllocations(const MeshData& data)
+    {
+        const size_t inlineChars = std::string().capacity();
+        size_t count = size_t(!data.vertices.empty()) + size_t(!data.indices.empty()) + size_t(!data.textures.empty());
+        for (const TextureRef& texture : data.textures)
+            count += size_t(texture.type.size() > inlineChars) + size_t(texture.path.size() > inlineChars);
+        return count;
+    }
+
+    //  ,     
+    // ObjLoader    ,  Assimp  :  .obj    .
+    // GltfLoader     Assimp   .glb    .
+    //       24 
+    uint32_t conversionKey(const ImportOptions& options, const std::string& path)
+    {
+        const uint32_t weldKey = options.weldVertices && options.weldEpsilon > 0.0f
+            ? static_cast<uint32_t>(fnv1a(&options.weldEpsilon, sizeof(float))) & 0xFFFFFFu : 0u;
+        return (options.packVertices ? 1u : 0u) |
+            (options.optimizeVertexCache ? 2u : 0u) |
+            (options.optimizeOverdraw ? 4u : 0u) |
+            (options.generateLods ? 8u : 0u) |
+            (options.buildMeshlets ? 16u : 0u) |
+            (options.nativeObj && isObjPath(path) ? 32u : 0u) |
+            (options.weldVertices ? 64u : 0u) |
+            (options.nativeGltf && isGlbPath(path) ? 128u : 0u) |
+            (weldKey << 8);
+    }
+
+    void setStage(ImportProgress* progress, ImportStage stage)
+    {
+        if (!progress)
+            return;
+        progress->stage = stage;
+        progress->fraction = 0.0f;
+    }
+
+    //      Assimp     
+    class AssimpProgressHandler : public Assimp::ProgressHandler
+    {
+    public:
+        explicit AssimpProgressHandler(ImportProgress* progress) : m_progress(progress) {}
+
+        bool Update(float percentage) override
+        {
+            if (percentage >= 0.0f)
+                m_progress->fraction = percentage;
+            return !m_progress->cancel; // false  Assimp  
+        }
+
+    private:
+        ImportProgress* m_progress;
+    };
+}
+
+const char* importProfileName(ImportProfile profile)
+{
+    switch (profile)
+    {
+    case ImportProfile::FastPreview: return "Fast preview";
+    case ImportProfile::Balanced:    return "Balanced";
+    case ImportProfile::MaxQuality:  return "Max quality";
+    default:                         return "Custom";
+    }
+}
+
+void applyImportProfile(ImportOptions& options, ImportProfile profile)
+{
+    if (profile == ImportProfile::Custom)
+        return;
+
+    const bool preview = profile == ImportProfile::FastPreview;
+    const bool quality = profile == ImportProfile::MaxQuality;
+    options.assimpSteps = preview ? ASSIMP_STEPS_FAST_PREVIEW : quality ? ASSIMP_STEPS_MAX_QUALITY : ASSIMP_STEPS_BALANCED;
+    //       GPU      
+    options.weldVertices = true;
+    options.optimizeVertexCache = !preview;
+    options.optimizeOverdraw = quality;
+    options.generateLods = quality;
+    options.buildMeshlets = quality;
+}
+
+ImportProfile findImportProfile(const ImportOptions& options)
+{
+    for (ImportProfile profile : { ImportProfile::FastPreview, ImportProfile::Balanced, ImportProfile::MaxQuality })
+    {
+        ImportOptions reference = options;
+        applyImportProfile(reference, profile);
+        if (reference.assimpSteps == options.assimpSteps &&
+            reference.weldVertices == options.weldVertices &&
+            reference.optimizeVertexCache == options.optimizeVertexCache &&
+            reference.optimizeOverdraw == options.optimizeOverdraw &&
+            reference.generateLods == options.generateLods &&
+            reference.buildMeshlets == options.buildMeshlets)
+            return profile;
+    }
+    return ImportProfile::Custom;
+}
+
+Model::Model(const std::string& path, const ImportOptions& options)
+    : options(options)
+{
+    if (importCPU(path))
+        uploadPending(std::numeric_limits<double>::infinity());
+}
+
+Model::Model(const ImportOptions& options)
+    : options(options)
+{
+}
+
+Model::~Model()
+{
+    //  ,    , ; texturePool  
+    texturesCancelled = true;
+
+    // ,  ,     ,    
+    for (const auto& texture : pendingTextures)
+    {
+        if (texture->id != 0 && !texture->uploaded)
+            glDeleteTextures(1, &texture->id);
+    }
+
+    for (unsigned int id : textureRefs)
+        TextureRegistry::instance().release(id);
+
+    // ,    ,  
+    for (Mesh& mesh : meshes)
+        mesh.releaseBuffers();
+}
+
+void Model::setBufferDonor(Model* donor)
+{
+    donorMeshes.clear();
+    if (!donor)
+        return;
+    for (Mesh& mesh : donor->meshes)
+    {
+        if (mesh.contentHash != 0 && mesh.canDonateBuffers())
+            donorMeshes.emplace(mesh.contentHash, &mesh);
+    }
+}
+
+Mesh* Model::takeDonorMesh(uint64_t contentHash)
+{
+    auto found = donorMeshes.find(contentHash);
+    if (contentHash == 0 || found == donorMeshes.end())
+        return nullptr;
+    //       
+    Mesh* donor = found->second;
+    donorMeshes.erase(found);
+    return donor;
+}
+
+std::vector<std::string> Model::getSourceFiles() const
+{
+    std::vector<std::string> files;
+    if (sourcePath.empty())
+        return files;
+    files.push_back(TextureRegistry::canonicalPath(sourcePath));
+    for (const std::string& library : materialFiles)
+        files.push_back(TextureRegistry::canonicalPath(library));
+    for (const auto& texture : textures_loaded)
+        files.push_back(TextureRegistry::canonicalPath(directory + '/' + texture.first));
+    return files;
+}
+
+bool Model::importCPU(const std::string& path, ImportProgress* progress)
+{
+    auto start = std::chrono::steady_clock::now();
+    importStart = start;
+
+    const unsigned int flags = options.assimpSteps;
+    importStats.profile = findImportProfile(options);
+
+    sourcePath = path;
+    directory = path.substr(0, path.find_last_of("/\\"));
+    setStage(progress, ImportStage::Reading);
+    sceneGraph.clear();
+    instances.clear();
+
+    //          
+    bool hashed = false;
+    uint64_t sourceHash = options.useCache ? MeshCache::hashFile(path, hashed) : 0;
+    //  OBJ     (mtllib):      
+    materialFiles = isObjPath(path) ? objMaterialLibraries(path) : std::vector<std::string>();
+    for (const std::string& library : hashed ? materialFiles : std::vector<std::string>())
+    {
+        bool libraryHashed = false;
+        const uint64_t libraryHash = MeshCache::hashFile(library, libraryHashed);
+        sourceHash = fnv1a(&libraryHash, sizeof(libraryHash), sourceHash);
+    }
+    std::string cachePath = MeshCache::cachePathFor(path);
+
+    importStats.fromCache = hashed && loadFromCache(cachePath, sourceHash, flags, conversionKey(options, path));
+    if (!importStats.fromCache)
+    {
+        if (options.nativeGltf && isGlbPath(path) && importGlb(path, progress))
+            importStats.parser = "GLB loader";
+        else if (options.nativeObj && isObjPath(path) && importObj(path, progress))
+            importStats.parser = "OBJ loader";
+        else if (importWithAssimp(path, flags, progress))
+            importStats.parser = "Assimp";
+        else
+            return false;
+
+        //     (OBJ)       
+        if (sceneGraph.getNodeCount() == 0)
+            sceneGraph.addNode(SceneGraph::NO_PARENT, glm::mat4(1.0f));
+        if (instances.empty())
+        {
+            for (uint32_t i = 0; i < pendingMeshes.size(); ++i)
+                instances.push_back({ i, 0 });
+        }
+
+        if (hashed && !MeshCache::write(cachePath, sourceHash, flags, conversionKey(options, path), pendingMeshes,
+            instances, sceneGraph))
+            std::cerr << "ERROR::MESH_CACHE::Failed to write " << cachePath << std::endl;
+    }
+
+    buildInstanceLists();
+
+    //      GPU      
+    sceneGraph.update();
+    calculateBoundingBox();
+
+    //        GPU   
+    startTextureDecoding();
+
+    importStats.cpuMs = elapsedMs(start);
+    setStage(progress, ImportStage::Uploading);
+    return true;
+}
+
+bool Model::uploadPending(double budgetMs)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    //  :    
+    if (budgetMs == std::numeric_limits<double>::infinity() && texturePool)
+        texturePool->wait();
+
+    // -   :     PBO  
+    if (textureUploader)
+        textureUploader->generateMipmaps();
+
+    //  ,   ,  
+    uploadDecodedTextures(start, budgetMs);
+
+    //      ,      
+    size_t uploadedNow = 0;
+    while (meshes.size() < totalMeshCount && (uploadedNow == 0 || elapsedMs(start) < budgetMs))
+    {
+        uploadMesh(meshes.size());
+        ++uploadedNow;
+    }
+
+    //      
+    if (budgetMs == std::numeric_limits<double>::infinity() && textureUploader)
+        textureUploader->generateMipmaps();
+
+    importStats.uploadMs += elapsedMs(start);
+
+    if (meshes.size() < totalMeshCount || texturesUploaded < pendingTextures.size() ||
+        (textureUploader && textureUploader->hasPendingMipmaps()))
+        return false;
+
+    //   GPU:     
+    if (pendingCache || !pendingMeshes.empty() || !pendingTextures.empty())
+    {
+        importStats.textures.clear();
+        for (const auto& texture : pendingTextures)
+            importStats.textures.push_back(texture->timing);
+
+        texturePool.reset();
+        textureUploader.reset();
+        pendingTextures.clear();
+        pendingTextureIndex.clear();
+        pendingMeshes.clear();
+        pendingMeshes.shrink_to_fit();
+        pendingCache.reset();
+
+        if (options.sharedBuffers)
+            buildSharedGeometry();
+
+        importStats.loadMs = importStats.cpuMs + importStats.uploadMs;
+        std::cout << "Model loaded " << (importStats.fromCache ? std::string("from cache") : std::string("with ") + importStats.parser)
+            << " in " << importStats.loadMs << " ms (CPU " << importStats.cpuMs
+            << " ms, GPU upload " << importStats.uploadMs << " ms): " << sourcePath << std::endl;
+        std::cout << "  " << importStats.triangles << " triangles, vertex cache ACMR "
+            << importStats.cacheBefore.acmr << " -> " << importStats.cacheAfter.acmr << ", ATVR "
+            << importStats.cacheBefore.atvr << " -> " << importStats.cacheAfter.atvr << std::endl;
+        if (importStats.overdrawTriangles)
+        {
+            std::cout << "  overdraw " << importStats.overdrawBefore << " -> " << importStats.overdrawAfter
+                << " (" << importStats.overdrawTriangles << " triangles measured)" << std::endl;
+        }
+        if (importStats.weldVerticesAfter)
+            std::cout << "  vertex welding: " << importStats.weldVerticesBefore << " -> " << importStats.weldVerticesAfter
+                << " vertices in " << importStats.weldedMeshes << " meshes (x"
+                << double(importStats.weldVerticesBefore) / importStats.weldVerticesAfter << ")" << std::endl;
+        if (importStats.meshlets)
+            std::cout << "  " << importStats.meshlets << " meshlets for cluster culling" << std::endl;
+        if (importStats.lodMeshes)
+        {
+            std::cout << "  LOD chains in " << importStats.lodMeshes << " meshes, "
+                << importStats.lodTriangles << " triangles in coarse levels" << std::endl;
+        }
+        std::cout << "  vertices: " << importStats.vertexBytes / 1024 << " KB in GPU ("
+            << importStats.vertexBytesFull / 1024 << " KB as Vertex), meshes by format:";
+        for (unsigned int f = 0; f < VERTEX_FORMAT_COUNT; ++f)
+        {
+            if (importStats.meshesByFormat[f])
+                std::cout << " " << vertexFormatName(VertexFormat(f)) << " " << importStats.meshesByFormat[f];
+        }
+        std::cout << std::endl;
+        importStats.residentBytes = residentBytes();
+        std::cout << "  CPU memory of meshes: " << importStats.cpuBytesBefore / 1024 << " KB after upload, "
+            << importStats.cpuBytesAfter / 1024 << " KB resident (" << meshResidencyName(options.residency) << ")" << std::endl;
+        if (importStats.meshesReused)
+            std::cout << "  GPU buffers of " << importStats.meshesReused << " unchanged meshes reused, "
+                << importStats.reusedBytes / 1024 << " KB not uploaded" << std::endl;
+        if (importStats.instances > totalMeshCount)
+            std::cout << "  instances: " << importStats.instances << " of " << totalMeshCount << " meshes, "
+                << importStats.instancedBytesSaved / 1024 << " KB of duplicate geometry not uploaded" << std::endl;
+        std::cout << "  indices: " << importStats.indexBytes / 1024 << " KB in GPU, 16-bit in "
+            << importStats.shortIndexMeshes << "/" << totalMeshCount << " meshes, saved "
+            << importStats.indexBytesSaved / 1024 << " KB" << std::endl;
+        if (options.packVertices && !importStats.fromCache)
+            std::cout << "  quantization error: position " << importStats.quantization.position
+                << ", normal " << importStats.quantization.normalDegrees << " deg, uv "
+                << importStats.quantization.texCoord << std::endl;
+        if (importStats.texturesShared)
+            std::cout << "  textures shared with loaded models: " << importStats.texturesShared << std::endl;
+        if (!importStats.fromCache)
+            std::cout << "  file parsing: " << importStats.parseMs << " ms" << std::endl;
+        if (!importStats.fromCache)
+            std::cout << "  mesh conversion: " << importStats.convertMs << " ms on "
+                << importStats.threads << " thread(s)" << std::endl;
+        if (!importStats.steps.empty())
+            std::cout << "  import steps (" << importProfileName(importStats.profile) << " profile):" << std::endl;
+        for (const ImportStepTiming& step : importStats.steps)
+            std::cout << "    " << step.name << ": " << step.ms << " ms" << (step.threadTime ? " (sum over threads)" : "") << std::endl;
+        if (importStats.scratchPeakBytes)
+            std::cout << "  scratch arenas: " << importStats.scratchPeakBytes / 1024 << " KB peak" << std::endl;
+        std::cout << "  process memory: " << importStats.residentBytes / (1024 * 1024) << " MB resident, "
+            << peakResidentBytes() / (1024 * 1024) << " MB peak" << std::endl;
+        if (importStats.allocationsMax)
+            std::cout << "  heap allocations per mesh in processMesh: " << importStats.allocationsMin
+                << ".." << importStats.allocationsMax << ", unexpected in " << importStats.allocationMismatches
+                << " meshes" << std::endl;
+        for (const TextureTiming& t : importStats.textures)
+            std::cout << "  texture " << t.path
+                << ": decode " << t.decodeStartMs << " +" << t.decodeMs << " ms"
+                << ", upload " << t.uploadStartMs << " +" << t.uploadMs << " ms" << std::endl;
+    }
+
+    return true;
+}
+
+float Model::getUploadProgress() const
+{
+    size_t total = totalMeshCount + pendingTextures.size();
+    if (total == 0)
+        return 1.0f;
+    return float(meshes.size() + texturesUploaded) / total;
+}
+
+void Model::uploadDecodedTextures(std::chrono::steady_clock::time_point start, double budgetMs)
+{
+    for (auto& pending : pendingTextures)
+    {
+        PendingTexture& texture = *pending;
+        if (texture.uploaded || !texture.decoded)
+            continue;
+
+        if (!textureUploader)
+            textureUploader.reset(new TextureUploader());
+
+        auto uploadStart = std::chrono::steady_clock::now();
+        texture.timing.uploadStartMs = msBetween(importStart, uploadStart);
+
+        TextureRegistry& registry = TextureRegistry::instance();
+
+        //         GPU   
+        unsigned int shared = 0;
+        if (texture.image.valid() && texture.image.contentHash != 0)
+            shared = registry.acquireByHash(texture.image.contentHash, texture.key);
+
+        if (shared != 0)
+        {
+            if (texture.id != 0)
+            {
+                replaceTexture(texture.id, shared);
+                glDeleteTextures(1, &texture.id);
+            }
+            texture.id = shared;
+            ++importStats.texturesShared;
+        }
+        else
+        {
+            // id    ,      
+            if (texture.id == 0)
+                glGenTextures(1, &texture.id);
+            if (textureUploader->upload(texture.id, texture.image))
+            {
+                registry.add(texture.key, texture.id, texture.image.contentHash);
+            }
+            else
+            {
+                //    (   ):  TextureFromFile   ,
+                //      ,       
+                replaceTexture(texture.id, 0);
+                glDeleteTextures(1, &texture.id);
+                texture.id = 0;
+            }
+        }
+        if (texture.id != 0)
+            textureRefs.push_back(texture.id);
+
+        texture.image.pixels.reset(); //    PBO
+        texture.uploaded = true;
+        ++texturesUploaded;
+        texture.timing.uploadMs = elapsedMs(uploadStart);
+
+        if (elapsedMs(start) >= budgetMs)
+            return;
+    }
+}
+
+void Model::uploadMesh(size_t index)
+{
+    //    meshes   
+    if (meshes.empty())
+    {
+        meshes.reserve(totalMeshCount);
+        meshColors.reserve(totalMeshCount);
+    }
+
+    std::vector<Texture> textures;
+    for (const TextureRef& ref : getPendingTextures(index))
+        textures.push_back(loadTexture(ref.path, ref.type));
+
+    glm::vec3 color;
+    Mesh* donor = nullptr;
+    if (pendingCache)
+    {
+        //      GPU    
+        const MeshCacheEntry& entry = pendingCache->getEntry(index);
+        donor = takeDonorMesh(entry.contentHash);
+        meshes.emplace_back(
+            VertexFormat(entry.vertexFormat),
+            pendingCache->getVertices(index), entry.vertexCount,
+            pendingCache->getIndices(index), entry.indexCount, entry.indexSize,
+            textures,
+            glm::vec3(entry.boundsMin[0], entry.boundsMin[1], entry.boundsMin[2]),
+            glm::vec3(entry.boundsMax[0], entry.boundsMax[1], entry.boundsMax[2]),
+            glm::vec3(entry.sphereCenter[0], entry.sphereCenter[1], entry.sphereCenter[2]), entry.sphereRadius,
+            donor);
+        color = glm::vec3(entry.color[0], entry.color[1], entry.color[2]);
+
+        Mesh& cached = meshes.back();
+        cached.cacheBefore.acmr = entry.acmrBefore;
+        cached.cacheBefore.atvr = entry.atvrBefore;
+        cached.cacheAfter.acmr = entry.acmrAfter;
+        cached.cacheAfter.atvr = entry.atvrAfter;
+        cached.overdrawBefore = entry.overdrawBefore;
+        cached.overdrawAfter = entry.overdrawAfter;
+        cached.verticesBeforeWeld = entry.verticesBeforeWeld;
+        cached.contentHash = entry.contentHash;
+        cached.lods.assign(entry.lods, entry.lods + entry.lodCount);
+        cached.meshlets.assign(pendingCache->getMeshlets(index), pendingCache->getMeshlets(index) + entry.meshletCount);
+    }
+    else
+    {
+        color = pendingMeshes[index].color;
+        donor = takeDonorMesh(pendingMeshes[index].contentHash);
+        meshes.emplace_back(std::move(pendingMeshes[index]), std::move(textures), donor);
+    }
+
+    meshColors.push_back(color);
+
+    Mesh& mesh = meshes.back();
+    //           
+    if (donor && !donor->canDonateBuffers())
+    {
+        ++importStats.meshesReused;
+        importStats.reusedBytes += mesh.getVertexBytes() + mesh.getIndexCount() * mesh.getIndexSize();
+    }
+
+    //     
+    const size_t triangles = mesh.getLod(0).indexCount / 3;
+    const size_t vertices = mesh.getVertexCount();
+    if (importStats.triangles + triangles > 0)
+    {
+        float w = float(triangles) / float(importStats.triangles + triangles);
+        importStats.cacheBefore.acmr += (mesh.cacheBefore.acmr - importStats.cacheBefore.acmr) * w;
+        importStats.cacheAfter.acmr += (mesh.cacheAfter.acmr - importStats.cacheAfter.acmr) * w;
+    }
+    if (importStats.vertices + vertices > 0)
+    {
+        float w = float(vertices) / float(importStats.vertices + vertices);
+        importStats.cacheBefore.atvr += (mesh.cacheBefore.atvr - importStats.cacheBefore.atvr) * w;
+        importStats.cacheAfter.atvr += (mesh.cacheAfter.atvr - importStats.cacheAfter.atvr) * w;
+    }
+    if (mesh.overdrawBefore > 0.0f && triangles > 0)
+    {
+        float w = float(triangles) / float(importStats.overdrawTriangles + triangles);
+        importStats.overdrawBefore += (mesh.overdrawBefore - importStats.overdrawBefore) * w;
+        importStats.overdrawAfter += (mesh.overdrawAfter - importStats.overdrawAfter) * w;
+        importStats.overdrawTriangles += triangles;
+    }
+    importStats.triangles += triangles;
+    importStats.meshlets += mesh.meshlets.size();
+    if (mesh.getLodCount() > 1)
+    {
+        ++importStats.lodMeshes;
+        for (unsigned int lod = 1; lod < mesh.getLodCount(); ++lod)
+            importStats.lodTriangles += mesh.getLod(lod).indexCount / 3;
+    }
+    importStats.vertices += vertices;
+    if (mesh.verticesBeforeWeld)
+    {
+        ++importStats.weldedMeshes;
+        importStats.weldVerticesBefore += mesh.verticesBeforeWeld;
+        importStats.weldVerticesAfter += vertices;
+    }
+
+    importStats.vertexBytes += mesh.getVertexBytes();
+    importStats.vertexBytesFull += mesh.getVertexCount() * sizeof(Vertex);
+    ++importStats.meshesByFormat[static_cast<unsigned int>(mesh.getVertexFormat())];
+
+    importStats.indexBytes += mesh.getIndexCount() * mesh.getIndexSize();
+    const unsigned int copies = getMeshInstanceCount(static_cast<int>(index));
+    if (copies > 1)
+        importStats.instancedBytesSaved += (copies - 1) * (mesh.getVertexBytes() + mesh.getIndexCount() * mesh.getIndexSize());
+    if (mesh.getIndexSize() == 2)
+    {
+        importStats.indexBytesSaved += mesh.getIndexCount() * (sizeof(unsigned int) - sizeof(uint16_t));
+        ++importStats.shortIndexMeshes;
+    }
+
+    // ---      ---
+    // (            ,    GPU)
+    mesh.setInfo(u8" " + std::to_string(index + 1) + u8"    ");
+
+    //    GPU:   CPU   ,    options.residency
+    importStats.cpuBytesBefore += mesh.getCpuBytes();
+    if (pendingCache)
+        mesh.releaseGeometry(options.residency, pendingCache->getVertices(index), pendingCache->getIndices(index));
+    else
+        mesh.releaseGeometry(options.residency);
+    importStats.cpuBytesAfter += mesh.getCpuBytes();
+}
+
+std::vector<TextureRef> Model::getPendingTextures(size_t index) const
+{
+    if (!pendingCache)
+        return pendingMeshes[index].textures;
 
-    // 2.   
-    glm::mat4 modelMat = glm::mat4(1.0f);
-    modelMat = glm::translate(modelMat, position);
-    modelMat = modelMat * rotationMatrix;
-    modelMat = glm::scale(modelMat, glm::vec3(scale)); //  scale
+    std::vector<TextureRef> textures;
+    for (size_t t = 0; t < pendingCache->getEntry(index).textureCount; ++t)
+        textures.push_back({ pendingCache->getTextureType(index, t), pendingCache->getTexturePath(index, t) });
+    return textures;
+}
 
+void Model::startTextureDecoding()
+{
+    TextureRegistry& registry = TextureRegistry::instance();
 
-    // 3.   
-    shader.setMat4("model", modelMat);
+    //       
+    for (size_t i = 0; i < totalMeshCount; ++i)
+    {
+        for (const TextureRef& ref : getPendingTextures(i))
+        {
+            if (textures_loaded.count(ref.path) || pendingTextureIndex.count(ref.path))
+                continue;
 
-    for (size_t i = 0; i < meshes.size(); ++i)
+            //    GPU    (    )   
+            std::string key = TextureRegistry::canonicalPath(directory + '/' + ref.path);
+            unsigned int id = registry.acquire(key);
+            if (id != 0)
+            {
+                textures_loaded[ref.path] = { id, ref.type, ref.path };
+                textureRefs.push_back(id);
+                ++importStats.texturesShared;
+                continue;
+            }
+
+            pendingTextureIndex.emplace(ref.path, pendingTextures.size());
+            pendingTextures.emplace_back(new PendingTexture());
+            pendingTextures.back()->path = ref.path;
+            pendingTextures.back()->key = key;
+            pendingTextures.back()->timing.path = ref.path;
+        }
+    }
+
+    if (pendingTextures.empty())
+        return;
+
+    //     : PNG  ,
+    //   GL   ,   
+    texturePool.reset(new ThreadPool(options.threads));
+    for (auto& pending : pendingTextures)
     {
+        PendingTexture* texture = pending.get();
+        texturePool->submit([this, texture]
+        {
+            if (texturesCancelled)
+                return;
 
-        if (!meshVisible[i])
-            continue; //   , 
+            auto decodeStart = std::chrono::steady_clock::now();
+            texture->timing.decodeStartMs = msBetween(importStart, decodeStart);
+            texture->image = decodeTexture(directory + '/' + texture->path, options.shareTexturesByContent);
+            texture->timing.decodeMs = elapsedMs(decodeStart);
+            texture->decoded = true;
+        });
+    }
+}
 
-        // ,      
-        if (i >= meshColors.size())
-            meshColors.push_back(glm::vec3(1.0f)); //   
+void Model::buildInstanceLists()
+{
+    //    ,      :  
+    meshInstanceStart.assign(totalMeshCount + 1, 0);
+    for (const MeshInstance& instance : instances)
+        ++meshInstanceStart[instance.mesh + 1];
+    for (size_t i = 0; i < totalMeshCount; ++i)
+        meshInstanceStart[i + 1] += meshInstanceStart[i];
 
-        //     ,  
-        if (meshes[i].textures.empty())
+    std::vector<uint32_t> next(meshInstanceStart.begin(), meshInstanceStart.end() - 1);
+    meshInstanceList.resize(instances.size());
+    for (uint32_t k = 0; k < instances.size(); ++k)
+        meshInstanceList[next[instances[k].mesh]++] = k;
+
+    instanceVisible.assign(instances.size(), true);
+    selectedInstance = -1;
+    importStats.instances = instances.size();
+}
+
+void Model::calculateBoundingBox()
+{
+    //      ,       
+    for (const MeshInstance& instance : instances)
+    {
+        glm::vec3 meshMin, meshMax;
+        if (pendingCache)
+        {
+            const MeshCacheEntry& entry = pendingCache->getEntry(instance.mesh);
+            meshMin = glm::vec3(entry.boundsMin[0], entry.boundsMin[1], entry.boundsMin[2]);
+            meshMax = glm::vec3(entry.boundsMax[0], entry.boundsMax[1], entry.boundsMax[2]);
+        }
+        else
         {
-            shader.setVec3("objectColor", meshColors[i]);
+            meshMin = pendingMeshes[instance.mesh].boundsMin;
+            meshMax = pendingMeshes[instance.mesh].boundsMax;
         }
 
-        meshes[i].Draw(shader);
+        transformBounds(meshMin, meshMax, sceneGraph.getWorld(instance.node), meshMin, meshMax);
+        minBounds = glm::min(minBounds, meshMin);
+        maxBounds = glm::max(maxBounds, meshMax);
     }
-
 }
 
-void Model::loadModel(const std::string& path)
+bool Model::importWithAssimp(const std::string& path, unsigned int flags, ImportProgress* progress)
 {
+    auto parseStart = std::chrono::steady_clock::now();
+
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path,
-        aiProcess_Triangulate |
-        aiProcess_FlipUVs |
-        aiProcess_CalcTangentSpace);
+    if (progress)
+        importer.SetProgressHandler(new AssimpProgressHandler(progress)); // Importer   
+    //   :   ,      
+    importer.SetPropertyBool(AI_CONFIG_PP_FD_REMOVE, true);
+    importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+
+    unsigned int timedSteps = 0;
+    for (const AssimpStep& step : ASSIMP_STEPS)
+        timedSteps |= step.flag;
+
+    auto stepStart = std::chrono::steady_clock::now();
+    const aiScene* scene = importer.ReadFile(path, flags & ~timedSteps);
+    importStats.steps.push_back({ "Assimp: read file", elapsedMs(stepStart), false });
+
+    //   :    (   
+    //  )    ,     ,   
+    for (const AssimpStep& step : ASSIMP_STEPS)
+    {
+        if (!scene || isCancelled(progress) || !(flags & step.flag))
+            continue;
+        stepStart = std::chrono::steady_clock::now();
+        scene = importer.ApplyPostProcessing(step.flag);
+        importStats.steps.push_back({ step.name, elapsedMs(stepStart), false });
+    }
+
+    if (isCancelled(progress))
+        return false;
 
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
     {
         std::cerr << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl;
-        return;
+        return false;
     }
 
-    directory = path.substr(0, path.find_last_of("/\\"));
-    processNode(scene->mRootNode, scene);
+    processNode(scene->mRootNode, instances, sceneGraph);
+    const std::vector<const aiMesh*> sceneMeshes = referencedMeshes(scene, instances);
+    importStats.parseMs = elapsedMs(parseStart);
 
-    //       
-    meshVisible.resize(meshes.size(), true);
+    std::vector<MeshData> meshData(sceneMeshes.size());
+#ifdef ALLOCATION_COUNTER
+    //    processMesh   :        
+    //     expectedProcessMeshAllocations;    importStats
+    std::vector<size_t> allocations(sceneMeshes.size(), 0);
+    std::vector<size_t> expected(sceneMeshes.size(), 0);
+    bool converted = convertMeshes(meshData, [&](size_t i, MeshData& data)
+    {
+        AllocationScope scope;
+        processMesh(sceneMeshes[i], scene, data);
+        allocations[i] = scope.count();
+        expected[i] = expectedProcessMeshAllocations(data);
+    }, progress);
 
-    // ---       ---
-    for (size_t i = 0; i < meshes.size(); ++i)
+    if (!allocations.empty())
     {
-        meshes[i].setInfo(u8" " + std::to_string(i + 1) + u8"    ");
-        // 1    (...)
-        meshes[i].setInfo(u8" " + std::to_string(i + 1) + u8"    ");
-        // 2    (...)
-        meshes[i].setInfo(u8" " + std::to_string(i + 1) + u8"    ");
-        // 3    (...)
-        meshes[i].setInfo(u8" " + std::to_string(i + 1) + u8"    ");
-        // 4    (...)
+        auto range = std::minmax_element(allocations.begin(), allocations.end());
+        importStats.allocationsMin = *range.first;
+        importStats.allocationsMax = *range.second;
     }
+    for (size_t i = 0; i < allocations.size(); ++i)
+        importStats.allocationMismatches += allocations[i] != expected[i];
+#else
+    bool converted = convertMeshes(meshData, [&](size_t i, MeshData& data)
+    {
+        processMesh(sceneMeshes[i], scene, data);
+    }, progress);
+#endif
+    return converted;
 }
 
-size_t Model::getMeshCount() const {
-    return meshes.size();
+bool Model::importGlb(const std::string& path, ImportProgress* progress)
+{
+    auto parseStart = std::chrono::steady_clock::now();
+
+    std::vector<MeshData> meshData;
+    std::string reason;
+    if (!loadGlb(path, meshData, instances, reason, sceneGraph))
+    {
+        std::cout << "GLB loader: " << reason << ", falling back to Assimp: " << path << std::endl;
+        return false;
+    }
+    importStats.parseMs = elapsedMs(parseStart);
+    importStats.steps.push_back({ "GLB loader: parse", importStats.parseMs, false });
+
+    return convertMeshes(meshData, nullptr, progress);
 }
 
-void Model::drawForPicking(Shader& shader)
+bool Model::importObj(const std::string& path, ImportProgress* progress)
 {
-    if (!pickingEnabled)
-        return; //    :   
+    auto parseStart = std::chrono::steady_clock::now();
 
-    shader.use();
+    std::vector<MeshData> meshData;
+    std::string reason;
+    ObjLoadStats stats;
+    if (!loadObj(path, meshData, reason, options.threads, &stats))
+    {
+        std::cout << "OBJ loader: " << reason << ", falling back to Assimp: " << path << std::endl;
+        return false;
+    }
+    importStats.parseMs = elapsedMs(parseStart);
+    importStats.steps.push_back({ "OBJ loader: parse", importStats.parseMs, false });
+    std::cout << "OBJ loader: " << stats.bytes / (1024.0 * 1024.0) << " MB in " << stats.chunks << " chunk(s) on "
+        << stats.threads << " thread(s): parse " << stats.parseMs << " ms, merge " << stats.buildMs << " ms" << std::endl;
 
-    for (size_t i = 0; i < meshes.size(); ++i)
+    return convertMeshes(meshData, nullptr, progress);
+}
+
+bool Model::convertMeshes(std::vector<MeshData>& meshData, const std::function<void(size_t, MeshData&)>& fill,
+    ImportProgress* progress)
+{
+    // CPU-      
+    setStage(progress, ImportStage::Converting);
+    auto convertStart = std::chrono::steady_clock::now();
+
+    std::vector<QuantizationError> errors(meshData.size());
+    std::atomic<size_t> converted(0);
+    //     :      
+    std::vector<std::array<double, CONVERT_STEP_COUNT>> stepMs(meshData.size());
+    auto timed = [&](size_t i, ConvertStep step, const std::function<void()>& body)
+    {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        stepMs[i][step] += elapsedMs(start);
+    };
     {
-        if (!meshVisible[i])
-            continue; //   
+        //       ;      scratch
+        std::unique_ptr<ImportScratch> scratch(options.scratchArena ? new ImportScratch() : nullptr);
 
-        unsigned int id = i + 1; // ID  picking
-        glm::vec3 pickColor(
-            (id & 0xFF) / 255.0f,
-            ((id >> 8) & 0xFF) / 255.0f,
-            ((id >> 16) & 0xFF) / 255.0f
-        );
+        //       ,    ScratchScope
+        auto finish = [&](size_t i)
+        {
+            MeshData& data = meshData[i];
+            if (options.optimizeVertexCache)
+            {
+                timed(i, CONVERT_VERTEX_CACHE, [&] { optimizeMesh(data); });
+            }
+            else
+            {
+                data.cacheBefore = analyzeVertexCache(data.indices.data(), data.indices.size(), data.vertexCount());
+                data.cacheAfter = data.cacheBefore;
+            }
+
+            if (options.optimizeOverdraw)
+                timed(i, CONVERT_OVERDRAW, [&] { optimizeMeshOverdraw(data); });
+            if (options.buildMeshlets)
+                timed(i, CONVERT_MESHLETS, [&] { buildMeshlets(data); });
+            if (options.generateLods)
+                timed(i, CONVERT_LODS, [&] { generateLods(data); });
+
+            if (options.packVertices)
+                timed(i, CONVERT_PACK, [&] { packMeshVertices(data, errors[i]); });
+            data.compactIndices();
+            data.contentHash = data.computeContentHash();
+
+            if (progress)
+                progress->fraction = float(++converted) / meshData.size();
+        };
+
+        //    ,     :  
+        //    parallelFor   ,    
+        ThreadPool pool(options.threads);
+        std::vector<char> deferred(meshData.size(), 0);
+        pool.parallelFor(meshData.size(), [&](size_t i)
+        {
+            if (isCancelled(progress))
+                return;
 
-        shader.setVec3("pickingColor", pickColor);
-        meshes[i].DrawForPicking(shader, pickColor);
+            ScratchScope scope(scratch.get());
+            MeshData& data = meshData[i];
+            if (fill)
+                timed(i, CONVERT_FILL, [&] { fill(i, data); });
+
+            if (options.weldVertices)
+            {
+                if (data.vertexCount() >= WELD_PARALLEL_VERTICES)
+                {
+                    deferred[i] = 1;
+                    return;
+                }
+                timed(i, CONVERT_WELD, [&] { weldVertices(data, options.weldEpsilon); });
+            }
+            finish(i);
+        });
+
+        std::vector<size_t> large;
+        for (size_t i = 0; i < meshData.size(); ++i)
+        {
+            if (deferred[i])
+                large.push_back(i);
+        }
+        for (size_t i : large)
+        {
+            if (isCancelled(progress))
+                break;
+            //  ,    :     
+            timed(i, CONVERT_WELD, [&] { weldVertices(meshData[i], options.weldEpsilon, &pool); });
+        }
+        pool.parallelFor(large.size(), [&](size_t k)
+        {
+            if (isCancelled(progress))
+                return;
+            ScratchScope scope(scratch.get());
+            finish(large[k]);
+        });
+        importStats.threads = pool.getThreadCount();
+        importStats.scratchPeakBytes = scratch ? scratch->getPeakBytes() : 0;
+    }
+
+    if (isCancelled(progress))
+        return false;
+
+    importStats.convertMs = elapsedMs(convertStart);
+
+    const bool stepEnabled[CONVERT_STEP_COUNT] = {
+        static_cast<bool>(fill), options.weldVertices, options.optimizeVertexCache, options.optimizeOverdraw,
+        options.buildMeshlets, options.generateLods, options.packVertices
+    };
+    for (unsigned int step = 0; step < CONVERT_STEP_COUNT; ++step)
+    {
+        if (!stepEnabled[step])
+            continue;
+        double total = 0.0;
+        for (const auto& mesh : stepMs)
+            total += mesh[step];
+        importStats.steps.push_back({ CONVERT_STEP_NAMES[step], total, true });
+    }
+
+    //    ;      
+    if (options.weldVertices)
+    {
+        size_t reported = 0;
+        for (size_t i = 0; i < meshData.size(); ++i)
+        {
+            const MeshData& data = meshData[i];
+            if (data.verticesBeforeWeld <= data.vertexCount())
+                continue;
+            if (reported++ == WELD_REPORT_MESHES)
+                continue;
+            std::cout << "Welded mesh " << i << ": " << data.verticesBeforeWeld << " -> " << data.vertexCount()
+                << " vertices (x" << double(data.verticesBeforeWeld) / std::max<size_t>(data.vertexCount(), 1) << ")" << std::endl;
+        }
+        if (reported > WELD_REPORT_MESHES)
+            std::cout << "Welded " << reported - WELD_REPORT_MESHES << " more mesh(es)" << std::endl;
     }
+
+    for (const QuantizationError& error : errors)
+    {
+        importStats.quantization.position = std::max(importStats.quantization.position, error.position);
+        importStats.quantization.normalDegrees = std::max(importStats.quantization.normalDegrees, error.normalDegrees);
+        importStats.quantization.texCoord = std::max(importStats.quantization.texCoord, error.texCoord);
+    }
+
+    //  GL  ,   ,    
+    pendingMeshes = std::move(meshData);
+    totalMeshCount = pendingMeshes.size();
+    return true;
 }
 
-unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma = false)
+namespace
 {
-    std::string filename = std::string(path);
-    filename = directory + '/' + filename;
+    bool sameMeshData(const MeshData& a, const MeshData& b)
+    {
+        if (a.format != b.format || a.vertices != b.vertices || a.indices != b.indices || a.color != b.color
+            || a.textures.size() != b.textures.size())
+            return false;
+        for (size_t t = 0; t < a.textures.size(); ++t)
+        {
+            if (a.textures[t].type != b.textures[t].type || a.textures[t].path != b.textures[t].path)
+                return false;
+        }
+        return true;
+    }
 
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
+    //      :      
+    struct TriangleSums {
+        size_t triangles = 0;
+        glm::dvec3 position = glm::dvec3(0.0);
+        glm::dvec2 texCoord = glm::dvec2(0.0);
+        double magnitude = 0.0; //      
+    };
 
-    int width, height, nrComponents;
-    unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data)
+    TriangleSums triangleSums(const std::vector<MeshData>& meshes)
     {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-        else
+        TriangleSums sums;
+        for (const MeshData& data : meshes)
         {
-            std::cerr << "Unknown number of channels: " << nrComponents << std::endl;
-            stbi_image_free(data);
-            return 0;
+            sums.triangles += data.indices.size() / 3;
+            withVertexType(data.format, [&](auto* tag)
+            {
+                typedef typename std::remove_pointer<decltype(tag)>::type V;
+                if constexpr (!VertexTraits<V>::quantized)
+                {
+                    const V* vertices = data.vertexArray<V>();
+                    for (unsigned int index : data.indices)
+                    {
+                        const glm::dvec3 position(vertices[index].Position);
+                        sums.position += position;
+                        sums.magnitude += std::abs(position.x) + std::abs(position.y) + std::abs(position.z);
+                        if constexpr (VertexTraits<V>::texCoords)
+                            sums.texCoord += glm::dvec2(vertices[index].TexCoords);
+                    }
+                }
+            });
         }
+        return sums;
+    }
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+    //            float
+    bool sameTriangles(const std::vector<MeshData>& a, const std::vector<MeshData>& b)
+    {
+        const TriangleSums sa = triangleSums(a);
+        const TriangleSums sb = triangleSums(b);
+        const double positionTolerance = 1e-6 * std::max(1.0, sa.magnitude);
+        const double texCoordTolerance = 1e-6 * std::max(1.0, 3.0 * sa.triangles); // UV   0..1
+        const glm::dvec3 dp = glm::abs(sa.position - sb.position);
+        const glm::dvec2 dt = glm::abs(sa.texCoord - sb.texCoord);
+        return sa.triangles == sb.triangles
+            && std::max(dp.x, std::max(dp.y, dp.z)) <= positionTolerance
+            && std::max(dt.x, dt.y) <= texCoordTolerance;
+    }
+}
+
+LoaderComparison Model::compareLoaders(const std::string& path, unsigned int runs)
+{
+    LoaderComparison result;
+    result.runs = runs ? runs : 1;
+    const bool obj = isObjPath(path);
+    result.loader = obj ? "OBJ loader" : "GLB loader";
+
+    std::error_code error;
+    result.bytes = static_cast<size_t>(std::filesystem::file_size(path, error));
+    if (error)
+        result.bytes = 0;
+
+    std::vector<MeshData> native;
+    std::vector<MeshInstance> nativeInstances;
+    SceneGraph graph; //   ,     
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r < result.runs; ++r)
+    {
+        if (obj)
+            result.native = loadObj(path, native, result.reason);
+        else if (isGlbPath(path))
+            result.native = loadGlb(path, native, nativeInstances, result.reason, graph);
+        else
+            result.reason = "no native loader for this format";
+        if (!result.native)
+            break;
+    }
+    result.nativeMs = elapsedMs(start) / result.runs;
+
+    // Assimp:  ,    processMesh  ,    
+    std::vector<MeshData> assimp;
+    std::vector<MeshInstance> assimpInstances;
+    start = std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r < result.runs; ++r)
+    {
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(path, IMPORT_FLAGS);
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+        {
+            std::cerr << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl;
+            return result;
+        }
 
-        //    
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        assimpInstances.clear();
+        graph.clear();
+        processNode(scene->mRootNode, assimpInstances, graph);
+        const std::vector<const aiMesh*> sceneMeshes = referencedMeshes(scene, assimpInstances);
+        assimp.assign(sceneMeshes.size(), MeshData());
+        for (size_t i = 0; i < sceneMeshes.size(); ++i)
+            processMesh(sceneMeshes[i], scene, assimp[i]);
+    }
+    result.assimpMs = elapsedMs(start) / result.runs;
+    result.meshes = assimp.size();
 
-        stbi_image_free(data);
+    if (obj)
+    {
+        //    -,    
+        result.identical = result.native && sameTriangles(native, assimp);
     }
     else
     {
-        std::cerr << "Texture failed to load at path: " << filename << std::endl;
-        stbi_image_free(data);
-        return 0;
+        result.identical = result.native && native.size() == assimp.size()
+            && nativeInstances.size() == assimpInstances.size();
+        for (size_t i = 0; i < native.size() && result.identical; ++i)
+            result.identical = sameMeshData(native[i], assimp[i]);
+        for (size_t i = 0; i < nativeInstances.size() && result.identical; ++i)
+            result.identical = nativeInstances[i].mesh == assimpInstances[i].mesh;
     }
 
-    return textureID;
+    const double megabytes = result.bytes / (1024.0 * 1024.0);
+    std::cout << result.loader << " vs Assimp, " << result.runs << " run(s), " << megabytes << " MB: ";
+    if (result.native)
+        std::cout << result.nativeMs << " ms (" << megabytes * 1000.0 / result.nativeMs << " MB/s)";
+    else
+        std::cout << "unsupported (" << result.reason << ")";
+    std::cout << ", Assimp " << result.assimpMs << " ms (" << megabytes * 1000.0 / result.assimpMs << " MB/s), "
+        << result.meshes << " meshes, " << (result.identical ? "same" : "different") << " output: " << path << std::endl;
+    return result;
 }
 
-void Model::processNode(aiNode* node, const aiScene* scene)
+ImportBenchmark Model::benchmarkImport(const std::string& path, const ImportOptions& options, unsigned int runs)
 {
-    for (unsigned int i = 0; i < node->mNumMeshes; i++)
-    {
-        aiMesh* aiMesh = scene->mMeshes[node->mMeshes[i]];
+    ImportBenchmark result;
+    result.scratchArena = options.scratchArena;
+    result.runs = runs ? runs : 1;
 
-        //  Mesh  
-        Mesh newMesh = processMesh(aiMesh, scene);
-        meshes.push_back(newMesh);
+    //    ,        
+    ImportOptions benchmarkOptions = options;
+    benchmarkOptions.useCache = false;
 
-        //     
-        glm::vec3 meshColor(1.0f); //   
-        if (aiMesh->mMaterialIndex >= 0)
+    result.rssBefore = residentBytes();
+    double totalMs = 0.0;
+    for (unsigned int r = 0; r < result.runs; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
         {
-            aiMaterial* material = scene->mMaterials[aiMesh->mMaterialIndex];
-            aiColor3D color(1.0f, 1.0f, 1.0f);
-            if (material->Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS)
-                meshColor = glm::vec3(color.r, color.g, color.b);
+            Model model(path, benchmarkOptions);
+            totalMs += elapsedMs(start);
         }
-        meshColors.push_back(meshColor);
+        std::cout << "  import run " << r + 1 << ": " << elapsedMs(start) << " ms, resident "
+            << residentBytes() / (1024 * 1024) << " MB" << std::endl;
+    }
+    result.loadMs = totalMs / result.runs;
+    result.rssAfter = residentBytes();
+    result.peakRss = peakResidentBytes();
+
+    std::cout << "Import benchmark (" << (result.scratchArena ? "scratch arena" : "heap") << ", "
+        << result.runs << " run(s)): " << result.loadMs << " ms per import, resident "
+        << result.rssBefore / (1024 * 1024) << " -> " << result.rssAfter / (1024 * 1024) << " MB, peak "
+        << result.peakRss / (1024 * 1024) << " MB: " << path << std::endl;
+    return result;
+}
+
+bool Model::loadFromCache(const std::string& cachePath, uint64_t sourceHash, unsigned int flags, uint32_t conversion)
+{
+    std::unique_ptr<MeshCache> cache(new MeshCache());
+    if (!cache->open(cachePath, sourceHash, flags, conversion))
+        return false;
+
+    sceneGraph.reserve(cache->getNodeCount());
+    for (size_t i = 0; i < cache->getNodeCount(); ++i)
+    {
+        const MeshCacheNode& node = cache->getNode(i);
+        sceneGraph.addNode(node.parent, glm::make_mat4(node.local));
+    }
+    if (sceneGraph.getNodeCount() != cache->getNodeCount())
+    {
+        sceneGraph.clear(); //      
+        return false;
+    }
+    instances.assign(cache->getInstances(), cache->getInstances() + cache->getInstanceCount());
+
+    totalMeshCount = cache->getMeshCount();
+    pendingCache = std::move(cache);
+    return true;
+}
+
+size_t Model::getMeshCount() const {
+    return meshes.size();
+}
+
+void Model::drawForPicking(Shader& shader)
+{
+    if (!pickingEnabled)
+        return; //    :   
+
+    shader.use();
+    shader.setInt("drawData", DRAW_DATA_UNIT);
+
+    //        ,    Draw:    ,    
+    const glm::mat4 modelMat = getModelMatrix();
+    const glm::mat4 modelView = viewMatrix * modelMat;
+    const ClusterCuller culler(projectionMatrix * modelView, modelView, clusterBackfaceCulling);
+    ClusterStats pickingStats; //     Draw
+
+    //     Draw;      Draw
+    sceneGraph.update();
+    nodeCullerNode = SceneGraph::NO_PARENT;
+
+    //      :  ,   
+    if (usesIndirectDraw())
+        drawIndirect(shader, culler, true, pickingStats);
+    else
+        drawInstances(shader, culler, true, pickingStats);
+}
+
+void Model::processNode(aiNode* node, std::vector<MeshInstance>& instances, SceneGraph& graph, uint32_t parent)
+{
+    // aiMatrix4x4   , glm::mat4   
+    const aiMatrix4x4& m = node->mTransformation;
+    const glm::mat4 local(
+        m.a1, m.b1, m.c1, m.d1,
+        m.a2, m.b2, m.c2, m.d2,
+        m.a3, m.b3, m.c3, m.d3,
+        m.a4, m.b4, m.c4, m.d4);
+    const uint32_t sceneNode = graph.addNode(parent, local);
+
+    //      :    picking ID,
+    //          (referencedMeshes)
+    for (unsigned int i = 0; i < node->mNumMeshes; i++)
+    {
+        instances.push_back({ node->mMeshes[i], sceneNode });
     }
 
     //    
     for (unsigned int i = 0; i < node->mNumChildren; i++)
     {
-        processNode(node->mChildren[i], scene);
+        processNode(node->mChildren[i], instances, graph, sceneNode);
     }
 }
 
-Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
+namespace
 {
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
-    std::vector<Texture> textures;
+    //    ,    aiMesh      
+    VertexFormat chooseVertexFormat(const aiMesh* mesh, const aiScene* scene)
+    {
+        if (mesh->HasBones())
+            return VertexFormat::Full;
 
-    // 
-    for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+        if (!mesh->HasTextureCoords(0))
+            return VertexFormat::PositionNormal;
+
+        // CalcTangentSpace       UV,
+        //        
+        const aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+        bool normalMapped =
+            material->GetTextureCount(aiTextureType_NORMALS) > 0 ||
+            material->GetTextureCount(aiTextureType_HEIGHT) > 0;
+        if (mesh->HasTangentsAndBitangents() && normalMapped)
+            return VertexFormat::Tangent;
+
+        return VertexFormat::Static;
+    }
+
+    static_assert(sizeof(aiVector3D) == sizeof(glm::vec3), "aiVector3D must be three floats (no ASSIMP_DOUBLE_PRECISION)");
+
+    //   aiMesh   :  sizeof(T)   
+    //    stride.     ,   
+    template <class T>
+    void copyStream(const aiVector3D* source, unsigned int count, unsigned char* destination, size_t stride)
     {
-        Vertex vertex;
-        vertex.Position = { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z };
-        vertex.Normal = { mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z };
+        for (unsigned int i = 0; i < count; ++i, destination += stride)
+            std::memcpy(destination, &source[i], sizeof(T));
+    }
 
-        if (mesh->mTextureCoords[0])
-            vertex.TexCoords = { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y };
-        else
-            vertex.TexCoords = { 0.0f, 0.0f };
+    //   aiMesh   V   ; ,   V ,
+    //   .   aiMesh    .
+    //      .
+    template <class V>
+    void convertVertices(const aiMesh* mesh, V* out, glm::vec3& boundsMin, glm::vec3& boundsMax)
+    {
+        typedef VertexTraits<V> Traits;
+        const unsigned int count = mesh->mNumVertices;
+        unsigned char* base = reinterpret_cast<unsigned char*>(out);
 
-        vertices.push_back(vertex);
+        copyPositions(mesh->mVertices, count, sizeof(aiVector3D), base + offsetof(V, Position), sizeof(V),
+            boundsMin, boundsMax);
+        if (mesh->HasNormals())
+            copyStream<glm::vec3>(mesh->mNormals, count, base + offsetof(V, Normal), sizeof(V));
+
+        if constexpr (Traits::texCoords)
+        {
+            if (mesh->HasTextureCoords(0))
+                copyStream<glm::vec2>(mesh->mTextureCoords[0], count, base + offsetof(V, TexCoords), sizeof(V));
+        }
+
+        if constexpr (Traits::tangents)
+        {
+            if (mesh->HasTangentsAndBitangents())
+            {
+                copyStream<glm::vec3>(mesh->mTangents, count, base + offsetof(V, Tangent), sizeof(V));
+                copyStream<glm::vec3>(mesh->mBitangents, count, base + offsetof(V, Bitangent), sizeof(V));
+            }
+        }
+
+        if constexpr (Traits::bones)
+        {
+            for (unsigned int i = 0; i < count; i++)
+            {
+                for (int j = 0; j < MAX_BONE_INFLUENCE; j++)
+                    out[i].m_BoneIDs[j] = -1;
+            }
+        }
+
+        if constexpr (Traits::bones)
+        {
+            //  MAX_BONE_INFLUENCE   ,   
+            for (unsigned int b = 0; b < mesh->mNumBones; b++)
+            {
+                const aiBone* bone = mesh->mBones[b];
+                for (unsigned int w = 0; w < bone->mNumWeights; w++)
+                {
+                    V& vertex = out[bone->mWeights[w].mVertexId];
+                    for (int j = 0; j < MAX_BONE_INFLUENCE; j++)
+                    {
+                        if (vertex.m_BoneIDs[j] < 0)
+                        {
+                            vertex.m_BoneIDs[j] = static_cast<int>(b);
+                            vertex.m_Weights[j] = bone->mWeights[w].mWeight;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+//    :   aiScene,    GL    Model
+void Model::processMesh(const aiMesh* mesh, const aiScene* scene, MeshData& data)
+{
+    std::vector<unsigned int>& indices = data.indices;
+
+    // :    ,       
+    data.format = chooseVertexFormat(mesh, scene);
+    data.vertices.assign(size_t(mesh->mNumVertices) * vertexSize(data.format), 0);
+    withVertexType(data.format, [&](auto* tag)
+    {
+        typedef typename std::remove_pointer<decltype(tag)>::type V;
+        if constexpr (!VertexTraits<V>::quantized)
+            convertVertices<V>(mesh, data.vertexArray<V>(), data.boundsMin, data.boundsMax);
+    });
+
+    //       aiMesh (12   ),     
+    if (mesh->mNumVertices > 0)
+    {
+        data.sphereCenter = (data.boundsMin + data.boundsMax) * 0.5f;
+        data.sphereRadius = boundingRadius(mesh->mVertices, mesh->mNumVertices, sizeof(aiVector3D), data.sphereCenter);
     }
 
-    // 
+    // :         
+    size_t indexCount = 0;
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+        indexCount += mesh->mFaces[i].mNumIndices;
+    indices.resize(indexCount);
+    unsigned int* index = indices.data();
     for (unsigned int i = 0; i < mesh->mNumFaces; i++)
     {
-        aiFace face = mesh->mFaces[i];
-        for (unsigned int j = 0; j < face.mNumIndices; j++)
-            indices.push_back(face.mIndices[j]);
+        const aiFace& face = mesh->mFaces[i];
+        index = std::copy(face.mIndices, face.mIndices + face.mNumIndices, index);
     }
 
-    // 
+    // :      (     GL)
     if (mesh->mMaterialIndex >= 0)
     {
         aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-        aiColor3D color;
 
-        std::vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-        textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+        aiColor3D color(1.0f, 1.0f, 1.0f);
+        if (material->Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS)
+            data.color = glm::vec3(color.r, color.g, color.b);
 
-        std::vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
-        textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+        data.textures.reserve(material->GetTextureCount(aiTextureType_DIFFUSE) + material->GetTextureCount(aiTextureType_SPECULAR));
+        collectMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", data.textures);
+        collectMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", data.textures);
     }
-
-    return Mesh(vertices, indices, textures);
 }
 
-std::vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type, const std::string& typeName)
+void Model::collectMaterialTextures(aiMaterial* mat, aiTextureType type, const char* typeName, std::vector<TextureRef>& textures)
 {
-    std::vector<Texture> textures;
-
     for (unsigned int i = 0; i < mat->GetTextureCount(type); i++)
     {
         aiString str;
         mat->GetTexture(type, i, &str);
+        textures.push_back({ typeName, str.C_Str() });
+    }
+}
 
-        bool skip = false;
-        for (unsigned int j = 0; j < textures_loaded.size(); j++)
+Texture Model::loadTexture(const std::string& path, const std::string& typeName)
+{
+    auto loaded = textures_loaded.find(path);
+    if (loaded != textures_loaded.end())
+        return loaded->second;
+
+    // if texture hasn't been loaded already, load it
+    Texture texture;
+
+    auto pending = pendingTextureIndex.find(path);
+    if (pending != pendingTextureIndex.end())
+    {
+        //   :   GL ,   
+        PendingTexture& decoding = *pendingTextures[pending->second];
+        //     id 0    ,    
+        if (decoding.id == 0 && !decoding.uploaded)
+            glGenTextures(1, &decoding.id);
+        texture.id = decoding.id;
+    }
+    else
+    {
+        TextureRegistry& registry = TextureRegistry::instance();
+        std::string key = TextureRegistry::canonicalPath(directory + '/' + path);
+
+        texture.id = registry.acquire(key);
+        if (texture.id == 0)
         {
-            if (textures_loaded[j].path == str.C_Str())
-            {
-                textures.push_back(textures_loaded[j]);
-                skip = true;
-                break;
-            }
+            texture.id = TextureFromFile(path.c_str(), directory, false);
+            if (texture.id != 0)
+                registry.add(key, texture.id);
         }
+        if (texture.id != 0)
+            textureRefs.push_back(texture.id);
+    }
 
-        if (!skip)
-        {   // if texture hasn't been loaded already, load it
-            Texture texture;
-            texture.id = TextureFromFile(str.C_Str(), directory, false);
-            texture.type = typeName;
-            texture.path = str.C_Str();
-            textures.push_back(texture);
-            textures_loaded.push_back(texture); // add to loaded textures
+    texture.type = typeName;
+    texture.path = path;
+    textures_loaded[path] = texture; // add to loaded textures
+    return texture;
+}
+
+void Model::replaceTexture(unsigned int oldId, unsigned int newId)
+{
+    // ,   ,     id
+    for (Mesh& mesh : meshes)
+    {
+        for (Texture& texture : mesh.textures)
+        {
+            if (texture.id == oldId)
+                texture.id = newId;
         }
     }
 
-    return textures;
+    for (auto& loaded : textures_loaded)
+    {
+        if (loaded.second.id == oldId)
+            loaded.second.id = newId;
+    }
+}
+
+unsigned int Model::detachTexture(const std::string& key)
+{
+    for (auto& loaded : textures_loaded)
+    {
+        Texture& texture = loaded.second;
+        if (texture.id == 0 || TextureRegistry::canonicalPath(directory + '/' + loaded.first) != key)
+            continue;
+
+        //        (textureRefs). Ÿ ,    
+        // (id    loadTexture)       ,   
+        const unsigned int oldId = texture.id;
+        auto reference = std::find(textureRefs.begin(), textureRefs.end(), oldId);
+        if (reference == textureRefs.end())
+            return 0;
+        const unsigned int newId = TextureRegistry::instance().detach(key, 1);
+        if (newId == 0)
+            return oldId;
+
+        //          oldId
+        for (Mesh& mesh : meshes)
+        {
+            for (Texture& used : mesh.textures)
+            {
+                if (used.id == oldId && used.path == loaded.first)
+                    used.id = newId;
+            }
+        }
+        *reference = newId;
+        texture.id = newId;
+        return newId;
+    }
+    return 0;
 }
 
 void Model::setRotationMatrix(const glm::mat4& rot)
@@ -263,30 +2102,31 @@ void Model::setRotationMatrix(const glm::mat4& rot)
     rotationMatrix = rot;
 }
 
-//  
+//   
 
-void Model::selectMesh(int index)
+void Model::selectInstance(int index)
 {
-    if (index < 0 || index >= (int)meshes.size())
+    if (index < 0 || index >= (int)instances.size())
     {
-        selectedMeshIndex = -1; //  
+        selectedInstance = -1; //  
 
-        for (size_t i = 0; i < meshVisible.size(); ++i)
-            meshVisible[i] = true;
+        for (size_t i = 0; i < instanceVisible.size(); ++i)
+            instanceVisible[i] = true;
 
         return;
     }
 
-    //   
-    selectedMeshIndex = index;
+    //   :   ,     
+    selectedInstance = index;
 
-    for (size_t i = 0; i < meshVisible.size(); ++i)
-        meshVisible[i] = (i == index);
+    const size_t selected = static_cast<size_t>(index);
+    for (size_t i = 0; i < instanceVisible.size(); ++i)
+        instanceVisible[i] = (i == selected);
 
 }
 
-int Model::getSelectedMesh() const {
-    return selectedMeshIndex;
+int Model::getSelectedInstance() const {
+    return selectedInstance;
 }
 
 Mesh& Model::getMesh(int index) {
@@ -1,30 +1,280 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <cfloat>  //  FLT_MAX
 #include "Mesh.h"      //  Mesh  Texture
+#include "IndirectDraw.h" //  DrawData  DrawDataBuffer
+#include "SceneGraph.h" //  SceneGraph
 #include "Shader.h"    //  Shader
+#include "TextureLoader.h" //  DecodedTexture  TextureUploader
+#include "VertexPacking.h" //  QuantizationError
 #include <assimp/scene.h>  //  aiNode, aiScene, aiMesh, aiMaterial, aiTextureType
+#include <assimp/postprocess.h> //  aiProcess_*
+
+//  Assimp  . ,     Assimp.
+//           MaxQuality (  )
+const unsigned int ASSIMP_STEPS_FAST_PREVIEW =
+	aiProcess_Triangulate |
+	aiProcess_FlipUVs;
+// :   ,    , NaN    
+const unsigned int ASSIMP_STEPS_BALANCED = ASSIMP_STEPS_FAST_PREVIEW |
+	aiProcess_SortByPType |
+	aiProcess_FindDegenerates |
+	aiProcess_FindInvalidData;
+//       :   ,      
+const unsigned int ASSIMP_STEPS_MAX_QUALITY = ASSIMP_STEPS_BALANCED |
+	aiProcess_ValidateDataStructure |
+	aiProcess_RemoveRedundantMaterials |
+	aiProcess_OptimizeMeshes |
+	aiProcess_GenSmoothNormals |
+	aiProcess_CalcTangentSpace;
+
+//    Assimp    
+enum class ImportProfile {
+	FastPreview, //   :      
+	Balanced,    // +       ;  
+	MaxQuality,  // + , ,  , , LOD  
+	Custom       //          
+};
+
+const char* importProfileName(ImportProfile profile);
+
+//   
+struct ImportOptions {
+	unsigned int threads = 0; //    , 0    
+	unsigned int assimpSteps = ASSIMP_STEPS_BALANCED; // aiProcess_*:   Assimp
+	bool shareTexturesByContent = true; //   TextureRegistry    ,     
+	bool packVertices = false; //   (PackedVertex)   Vertex
+	bool weldVertices = true;        //     :     
+	float weldEpsilon = 0.0f;        //    ; 0    
+	bool optimizeVertexCache = true; //        GPU
+	bool optimizeOverdraw = false;   //      ( )
+	bool generateLods = false;       //       
+	bool buildMeshlets = false;      //   64     CPU
+	bool sharedBuffers = false;      //     VBO/EBO ,   base vertex
+	bool nativeGltf = true;          // .glb  GltfLoader;       Assimp
+	bool nativeObj = true;           // .obj  ObjLoader    ;   Assimp
+	MeshResidency residency = MeshResidency::Bounds; //      CPU    GPU
+	bool scratchArena = true;        //           ,    
+	bool useCache = true;            //    .meshcache;     
+};
+
+//   Assimp    ;   options  
+void applyImportProfile(ImportOptions& options, ImportProfile profile);
+// ,     options,  Custom
+ImportProfile findImportProfile(const ImportOptions& options);
+
+//    
+struct ImportStepTiming {
+	const char* name = "";
+	double ms = 0.0;
+	bool threadTime = false; //   :      ;    
+};
+
+//      GPU  ,    
+struct TextureTiming {
+	std::string path;
+	double decodeStartMs = 0.0;
+	double decodeMs = 0.0;   //  
+	double uploadStartMs = 0.0;
+	double uploadMs = 0.0;   //  GL
+};
+
+//    
+struct ImportStats {
+	bool fromCache = false; //    .meshcache, Assimp  
+	const char* parser = "Assimp"; //   : "Assimp", "GLB loader"  "OBJ loader"
+	double parseMs = 0.0;   //  :    MeshData  Assimp  aiScene, 
+	double loadMs = 0.0;    //    (CPU- +   GPU), 
+	double cpuMs = 0.0;     // ,    , 
+	double uploadMs = 0.0;  //     GPU, 
+	double convertMs = 0.0; //  aiMesh -> MeshData   , 
+	unsigned int threads = 0; //     
+	size_t allocationsMin = 0; //      processMesh ( Assimp  ALLOCATION_COUNTER):
+	size_t allocationsMax = 0; // , ,          
+	unsigned int allocationMismatches = 0; // ,    ,  
+	unsigned int texturesShared = 0; //    TextureRegistry    
+	size_t cpuBytesBefore = 0;    //  CPU      GPU (  MeshResidency::All)
+	size_t cpuBytesAfter = 0;     //  releaseGeometry  ImportOptions.residency
+	size_t scratchPeakBytes = 0;  //    scratch-   (0   )
+	size_t residentBytes = 0;     //   (RSS)  
+	size_t vertices = 0;
+	size_t triangles = 0;
+	unsigned int weldedMeshes = 0;  // ,  weldVertices
+	size_t weldVerticesBefore = 0;  //     
+	size_t weldVerticesAfter = 0;   //   GPU
+	VertexCacheStats cacheBefore; //   : ACMR   , ATVR   
+	VertexCacheStats cacheAfter;
+	size_t overdrawTriangles = 0; //   ,   
+	float overdrawBefore = 0.0f;  //    ,   
+	float overdrawAfter = 0.0f;
+	unsigned int lodMeshes = 0;   //    LOD
+	size_t lodTriangles = 0;      //      
+	size_t meshlets = 0;          //    
+	size_t vertexBytes = 0;       //    GPU
+	size_t vertexBytesFull = 0;   //         Vertex
+	unsigned int meshesByFormat[VERTEX_FORMAT_COUNT] = {}; //     VertexFormat
+	size_t instances = 0;         //    ;   GPU  getMeshCount()
+	size_t instancedBytesSaved = 0; //     ,     
+	unsigned int meshesReused = 0; // ,   GPU    (setBufferDonor)
+	size_t reusedBytes = 0;        //    ,    
+	size_t indexBytes = 0;        //    GPU
+	size_t indexBytesSaved = 0;   //  16-   32-
+	unsigned int shortIndexMeshes = 0; //   16- 
+	QuantizationError quantization; //       (    Assimp)
+	std::vector<TextureTiming> textures; //         
+	ImportProfile profile = ImportProfile::Custom; // ,    
+	std::vector<ImportStepTiming> steps; //  ,   Assimp    ;     
+};
+
+//        ,  
+struct ImportBenchmark {
+	bool scratchArena = false;
+	unsigned int runs = 0;
+	double loadMs = 0.0;     //   : importCPU    GPU
+	size_t rssBefore = 0;    //     
+	size_t rssAfter = 0;     //          
+	size_t peakRss = 0;      //      
+};
+
+//    : Draw    
+struct DrawBenchmark {
+	bool sharedBuffers = false; //     
+	bool indirect = false;      // glMultiDrawElementsIndirect    
+	unsigned int frames = 0;
+	double submitMs = 0.0;      // CPU-  Draw (  )
+	double finishMs = 0.0;      //  glFinish:    GPU,   Draw
+};
+
+//  IndirectDraw:         
+//  offscreen-,      ,   picking
+struct IndirectDrawCheck {
+	bool supported = false;        // multi-draw indirect      
+	int width = 0;
+	int height = 0;
+	size_t colorMismatches = 0;    //  Draw,   
+	size_t pickingMismatches = 0;  //    drawForPicking
+	size_t loopDrawCalls = 0;      //     
+	size_t indirectDrawCalls = 0;  //   IndirectDraw
+
+	bool passed() const { return supported && colorMismatches == 0 && pickingMismatches == 0; }
+};
+
+//      (GltfLoader, ObjLoader)  Assimp:
+//    MeshData  ,   GPU
+struct LoaderComparison {
+	const char* loader = "";  //   
+	bool native = false;   //    ;    reason
+	std::string reason;
+	unsigned int runs = 0;
+	size_t bytes = 0;      //      
+	double nativeMs = 0.0; //   
+	double assimpMs = 0.0;
+	size_t meshes = 0;
+	// GLB: , ,      .
+	// OBJ:    (,    UV )  Assimp    .
+	bool identical = false;
+};
+
+//   
+enum class ImportStage { Reading, Converting, Uploading, Done };
+
+//    :   ,   UI
+struct ImportProgress {
+	std::atomic<ImportStage> stage{ ImportStage::Reading };
+	std::atomic<float> fraction{ 0.0f }; //    , 0..1
+	std::atomic<bool> cancel{ false };
+};
+
+class MeshCache;
+class SharedGeometry;
+class ThreadPool;
 
 class Model
 {
 	public:
-		Model(const std::string& path)
-		{
-			loadModel(path);
-			calculateBoundingBox(); //     
-		}
+		//  :     GPU   
+		Model(const std::string& path, const ImportOptions& options = ImportOptions());
+		//       importCPU()  uploadPending()
+		explicit Model(const ImportOptions& options);
+		~Model();
+
+		//  1   ,   GL:    ,
+		//  ,  . false    .
+		bool importCPU(const std::string& path, ImportProgress* progress = nullptr);
+
+		//  2   GL:     GPU,   
+		//   ();      . true   .
+		bool uploadPending(double budgetMs);
+
+		//     :    contentHash    GPU
+		//  .   uploadPending; donor     .
+		//          donor  .
+		void setBufferDonor(Model* donor);
+
+		// ,    :  ,   OBJ  
+		//        
+		std::vector<std::string> getSourceFiles() const;
+
+		//      key      (HotReload).
+		//       GL        , key
+		//  (TextureRegistry::detach)       id  
+		//    . 0      .
+		unsigned int detachTexture(const std::string& key);
+
+		//        
+		size_t getTotalMeshCount() const { return totalMeshCount; }
+		//    GPU   , 0..1
+		float getUploadProgress() const;
 
 		void Draw(Shader& shader);
-		void selectMesh(int index);
+		//   (  picking ID - 1):   ; -1  
+		void selectInstance(int index);
 		void setRotationMatrix(const glm::mat4& rot);
 
-		int getSelectedMesh() const;
+		//      LOD; viewportHeight     
+		void setCamera(const glm::mat4& view, const glm::mat4& projection, float viewportHeight);
+		//   LOD  , ; 0    
+		void setLodThreshold(float pixels) { lodThreshold = pixels; }
+		float getLodThreshold() const { return lodThreshold; }
+		//    Draw      LOD
+		size_t getDrawnTriangles() const { return drawnTriangles; }
+		size_t getFullTriangles() const { return fullTriangles; }
+
+		//    :     (  )   .
+		//          ,    .
+		void setClusterCulling(bool frustum, bool backface) { clusterCulling = frustum; clusterBackfaceCulling = backface; }
+		const ClusterStats& getClusterStats() const { return clusterStats; } //   Draw
+
+		// CPU- Draw,    , 
+		double getDrawSubmitMs() const { return drawSubmitMs; }
+		bool usesSharedBuffers() const { return sharedGeometry != nullptr; }
+		//    :         multi-draw indirect.
+		//       .
+		void setIndirectDraw(bool enabled) { indirectEnabled = enabled; }
+		bool usesIndirectDraw() const;
+		size_t getDrawCalls() const { return drawCalls; } //     Draw
+		//   frames      ;    
+		DrawBenchmark benchmarkDraw(Shader& shader, unsigned int frames);
+		//      offscreen- width x height   ;
+		// view  projection    .    
+		IndirectDrawCheck compareIndirectDraw(Shader& shader, Shader& pickingShader, int width, int height);
+
+		int getSelectedInstance() const;
 
 		Mesh& getMesh(int index);
 
+		//          
 		glm::vec3 getSize() const { return maxBounds - minBounds; }
 		void setScale(float s) { scale = s; }
 		float getScale() const { return scale; }  
@@ -37,6 +287,29 @@ class Model
 
 		std::string getMeshInfo(int index) const { return meshes[index].getInfo(); }
 
+		//      ,          .
+		//    GPU  ,     glDrawElementsInstanced
+		size_t getInstanceCount() const { return instances.size(); }
+		const MeshInstance& getInstance(int index) const { return instances[index]; }
+		unsigned int getMeshInstanceCount(int mesh) const { return meshInstanceStart[mesh + 1] - meshInstanceStart[mesh]; }
+
+		//    .        (SceneGraph::setLocal):
+		// Draw      
+		SceneGraph& getSceneGraph() { return sceneGraph; }
+		const SceneGraph& getSceneGraph() const { return sceneGraph; }
+		//    Draw   , 
+		size_t getNodesUpdated() const { return nodesUpdated; }
+		double getSceneUpdateMs() const { return sceneUpdateMs; }
+
+		const ImportStats& getImportStats() const { return importStats; }
+
+		//   .glb  .obj    Assimp, runs  ;    
+		static LoaderComparison compareLoaders(const std::string& path, unsigned int runs);
+
+		//     runs    options  ;    .
+		//    GL.
+		static ImportBenchmark benchmarkImport(const std::string& path, const ImportOptions& options, unsigned int runs);
+
 	private:
 
 		// model data
@@ -44,36 +317,151 @@ class Model
 
 		std::vector<Mesh> meshes;
 
-		int selectedMeshIndex = -1;
+		//        ,   :
+		//   i  meshInstanceList[meshInstanceStart[i] .. meshInstanceStart[i + 1])
+		std::vector<MeshInstance> instances;
+		std::vector<uint32_t> meshInstanceStart;
+		std::vector<uint32_t> meshInstanceList;
+
+		int selectedInstance = -1;
 
 		std::vector<glm::vec3> meshColors;
-		std::vector<bool> meshVisible; //   
+		std::vector<bool> instanceVisible; //   
 		std::string directory;
-		std::vector<Texture> textures_loaded;
+		std::unordered_map<std::string, Texture> textures_loaded; //    -> 
+		std::vector<unsigned int> textureRefs; //   TextureRegistry,   
+		std::vector<std::string> materialFiles; //    mtllib OBJ (objMaterialLibraries)
 
 		float scale = 1.0f;
 		glm::vec3 position = glm::vec3(0.0f);   //  
 		glm::mat4 rotationMatrix = glm::mat4(1.0f); //  (Arcball   )
 
+		//    LOD
+		glm::mat4 viewMatrix = glm::mat4(1.0f);
+		glm::mat4 projectionMatrix = glm::mat4(1.0f);
+		float viewportHeight = 0.0f; // 0    ,   
+		float lodThreshold = 1.0f;
+		size_t drawnTriangles = 0;
+		size_t fullTriangles = 0;
+
+		bool clusterCulling = true;
+		bool clusterBackfaceCulling = false;
+		ClusterStats clusterStats;
+		IndexRanges visibleRanges; //     
+
+		//   (ImportOptions::sharedBuffers)   ,   VAO
+		std::unique_ptr<SharedGeometry> sharedGeometry;
+		std::vector<size_t> drawOrder;
+		double drawSubmitMs = 0.0;
+		size_t drawCalls = 0;
+
+		//     VAO,        IndirectDraw
+		struct DrawBatch {
+			size_t firstMesh;    //       
+			size_t firstCommand;
+			size_t commandCount;
+		};
+		bool indirectEnabled = true;
+		std::unique_ptr<IndirectDraw> indirectDraw;
+		std::vector<DrawBatch> drawBatches;
+
+		//   :       LOD
+		struct InstanceBatch {
+			uint32_t mesh;
+			unsigned int lod;
+			uint32_t instance;    //  :  count == 1     picking   uniform
+			uint32_t firstRecord; //    drawData 
+			uint32_t count;
+		};
+		std::vector<InstanceBatch> instanceBatches;
+		std::vector<DrawData> drawData;     //   ,   draw ID  instanceBase + gl_InstanceID
+		DrawDataBuffer drawDataBuffer;
+		std::vector<std::pair<uint32_t, unsigned int>> frameInstances; //   LOD,   
+
 		glm::vec3 minBounds = glm::vec3(FLT_MAX);
 		glm::vec3 maxBounds = glm::vec3(-FLT_MAX);
 
-		void loadModel(const std::string& path);
-		void processNode(aiNode* node, const aiScene* scene);
-		Mesh processMesh(aiMesh* mesh, const aiScene* scene);
-		std::vector<Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, const std::string& typeName);
-
-		void calculateBoundingBox()
-    {
-        for (const auto& mesh : meshes)
-        {
-            for (const auto& v : mesh.vertices)
-            {
-                minBounds = glm::min(minBounds, v.Position);
-                maxBounds = glm::max(maxBounds, v.Position);
-            }
-        }
-    }
+		//  ;      MeshInstance::node
+		SceneGraph sceneGraph;
+		size_t nodesUpdated = 0;
+		double sceneUpdateMs = 0.0;
+		//              
+		std::optional<ClusterCuller> nodeCuller;
+		uint32_t nodeCullerNode = SceneGraph::NO_PARENT;
+
+		ImportOptions options;
+		ImportStats importStats;
+
+		// ,          GPU
+		struct PendingTexture {
+			std::string path;                   //   
+			std::string key;                    //     TextureRegistry
+			DecodedTexture image;               //   
+			std::atomic<bool> decoded{ false }; // image   
+			unsigned int id = 0;                //  GL,    
+			bool uploaded = false;
+			TextureTiming timing;
+		};
+
+		// --- ,    GPU ---
+		std::string sourcePath;
+		std::chrono::steady_clock::time_point importStart;
+		size_t totalMeshCount = 0;
+		std::vector<MeshData> pendingMeshes;     // CPU-  Assimp
+		std::unique_ptr<MeshCache> pendingCache; //   
+
+		std::unordered_multimap<uint64_t, Mesh*> donorMeshes; // contentHash ->    
+
+		std::vector<std::unique_ptr<PendingTexture>> pendingTextures;
+		std::unordered_map<std::string, size_t> pendingTextureIndex; //  ->   pendingTextures
+		size_t texturesUploaded = 0;
+		std::unique_ptr<TextureUploader> textureUploader;
+		std::atomic<bool> texturesCancelled{ false };
+		//  :     ,  pendingTextures  
+		std::unique_ptr<ThreadPool> texturePool;
+
+		bool loadFromCache(const std::string& cachePath, uint64_t sourceHash, unsigned int flags, uint32_t conversion);
+		bool importWithAssimp(const std::string& path, unsigned int flags, ImportProgress* progress);
+		bool importGlb(const std::string& path, ImportProgress* progress);
+		bool importObj(const std::string& path, ImportProgress* progress);
+		//    ; fill ( )   MeshData   
+		bool convertMeshes(std::vector<MeshData>& meshData, const std::function<void(size_t, MeshData&)>& fill,
+			ImportProgress* progress);
+		void startTextureDecoding();
+		void uploadDecodedTextures(std::chrono::steady_clock::time_point start, double budgetMs);
+		std::vector<TextureRef> getPendingTextures(size_t index) const;
+		void uploadMesh(size_t index);
+		Mesh* takeDonorMesh(uint64_t contentHash);
+		//   Assimp:           aiScene,
+		//      graph
+		static void processNode(aiNode* node, std::vector<MeshInstance>& instances, SceneGraph& graph,
+			uint32_t parent = SceneGraph::NO_PARENT);
+		static void processMesh(const aiMesh* mesh, const aiScene* scene, MeshData& data);
+		static void collectMaterialTextures(aiMaterial* mat, aiTextureType type, const char* typeName, std::vector<TextureRef>& textures);
+		Texture loadTexture(const std::string& path, const std::string& typeName);
+		void replaceTexture(unsigned int oldId, unsigned int newId);
+
+		//        ;     
+		void buildInstanceLists();
+		void calculateBoundingBox();
+		void buildSharedGeometry();
+		//    instanceBatches     drawData.   
+		//   count > 1,   IndirectDraw (allRecords)  
+		void collectInstances(const ClusterCuller& culler, bool allRecords);
+		//     ; picking  -  
+		void drawInstances(Shader& shader, const ClusterCuller& culler, bool picking, ClusterStats& stats);
+		//    IndirectDraw
+		void drawIndirect(Shader& shader, const ClusterCuller& culler, bool picking, ClusterStats& stats);
+		glm::mat4 getModelMatrix() const;
+		//    ,       lodThreshold;
+		// meshMatrix       (   )
+		unsigned int selectLod(const Mesh& mesh, const glm::mat4& meshMatrix) const;
+		//      node  visibleRanges; nullptr     lod .
+		// culler    ;       
+		const IndexRanges* cullClusters(const Mesh& mesh, uint32_t node, unsigned int lod, const ClusterCuller& culler,
+			const glm::mat4& modelView, ClusterStats& stats);
+		//       
+		void updateSceneGraph();
 
 };
 
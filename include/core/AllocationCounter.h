@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+//      ,   ALLOCATION_COUNTER
+//    (   Debug,  Release  ).   operator new   AllocationCounter.cpp
+//       ,      
+//      .  ALLOCATION_COUNTER  operator new
+//  ,    0.
+
+//       
+size_t threadAllocationCount();
+
+//    :     count()
+class AllocationScope
+{
+public:
+	AllocationScope() : m_start(threadAllocationCount()) {}
+
+	size_t count() const { return threadAllocationCount() - m_start; }
+
+private:
+	size_t m_start;
+};
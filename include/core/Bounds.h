@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+struct MeshData;
+
+//     : AABB  .
+//   vec3  float   ,     stride  (  12),
+//        ,    aiMesh  glTF.
+//  min/max      SSE.
+
+//  count ;  count == 0 boundsMin  boundsMax  
+void positionBounds(const void* positions, size_t count, size_t stride, glm::vec3& boundsMin, glm::vec3& boundsMax);
+
+//    destination   destinationStride        
+//        
+void copyPositions(const void* positions, size_t count, size_t stride,
+	void* destination, size_t destinationStride, glm::vec3& boundsMin, glm::vec3& boundsMax);
+
+//     center,   
+float boundingRadius(const void* positions, size_t count, size_t stride, const glm::vec3& center);
+
+// AABB   matrix:    ,    .
+//     
+void transformBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& matrix,
+	glm::vec3& outMin, glm::vec3& outMax);
+
+// AABB       (  ).
+//       AABB:  ,    .
+void computeBounds(MeshData& data);
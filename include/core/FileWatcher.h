@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifdef _WIN32
+#include <filesystem>
+#endif
+
+//     ,   poll()   , .
+//      ,      
+const unsigned int FILE_WATCH_SETTLE_MS = 250;
+
+//            .
+//   :         .
+// Linux  inotify; Windows     ,  
+//       .
+class FileWatcher
+{
+public:
+	FileWatcher() = default;
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	//   (     TextureRegistry::canonicalPath);
+	// false     
+	bool watch(const std::string& path);
+	//     
+	void clear();
+
+	//  .   ,     ;    
+	std::vector<std::string> poll();
+
+	size_t getFileCount() const { return m_files.size(); }
+
+private:
+	std::unordered_set<std::string> m_files;
+	std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_changed; //  ->  
+
+	void readEvents();
+
+#ifdef _WIN32
+	std::unordered_map<std::string, void*> m_directories; //  -> HANDLE 
+	std::unordered_map<std::string, std::filesystem::file_time_type> m_writeTimes;
+#else
+	int m_fd = -1; //  inotify
+	std::unordered_map<int, std::string> m_directories; //   -> 
+#endif
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Mesh.h"
+#include "SceneGraph.h"
+
+//  glTF 2.0    (.glb)  Assimp.
+//    ,  JSON-,     
+//     MeshData     aiMesh.
+//
+//      Assimp   Model (Triangulate | FlipUVs |
+// CalcTangentSpace):          , 
+//   , UV     (Assimp   :  
+// glTF   FlipUVs).    (matrix  TRS)   graph  
+//  0;          instances,    glTF
+//      .
+//
+//   (ImportOptions::assimpSteps)   :    
+// (FindDegenerates, OptimizeMeshes  .)  ,     Balanced
+//  Max quality    Assimp.       .
+//
+//  : ,  , sparse-, , 
+//  ,  UV,   ( ), 
+//     .  loadGlb  false    reason,
+//     Assimp.
+bool loadGlb(const std::string& path, std::vector<MeshData>& meshes, std::vector<MeshInstance>& instances,
+	std::string& reason, SceneGraph& graph);
+
+//  .glb   ,   
+bool isGlbPath(const std::string& path);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "FileWatcher.h"
+#include "Model.h"
+#include "ModelLoader.h"
+#include "TextureLoader.h"
+
+//        UI
+struct HotReloadStats {
+	size_t watchedFiles = 0;
+	unsigned int modelReloads = 0;   //   (    )
+	unsigned int textureReloads = 0; //   
+	unsigned int lastTextures = 0;   //     
+	double lastTextureMs = 0.0;      //  :     GPU
+};
+
+//         (Model::getSourceFiles).
+//           GL  
+//  .  GL,      ,  
+// (Model::detachTexture):      .
+//     .mtl     ModelLoader  reuseBuffers:
+//       GPU  ,   
+//   TextureRegistry  .
+class HotReload
+{
+public:
+	//     GL,  ModelLoader::update. current    , path   .
+	//  loader ,      .
+	void update(Model* current, const std::string& path, ModelLoader& loader, const ImportOptions& options);
+
+	const HotReloadStats& getStats() const { return m_stats; }
+
+	//            GL
+	void shutdown();
+
+private:
+	FileWatcher m_watcher;
+	const Model* m_watched = nullptr; //    
+	std::unique_ptr<TextureUploader> m_uploader;
+	HotReloadStats m_stats;
+
+	void reloadTextures(Model* model, const std::vector<std::string>& keys);
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// ,      .
+//      ,     .
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	//      ; false       
+	bool open(const std::string& path);
+	void close();
+
+	bool isOpen() const { return m_data != nullptr; }
+	const unsigned char* data() const { return m_data; }
+	size_t size() const { return m_size; }
+
+private:
+	const unsigned char* m_data = nullptr; //  
+	size_t m_size = 0; //    
+
+#ifdef _WIN32
+	void* m_file = nullptr; // HANDLE 
+	void* m_mapping = nullptr; // HANDLE  
+#else
+	int m_fd = -1; //  
+#endif
+};
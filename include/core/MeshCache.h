@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Mesh.h"
+#include "MappedFile.h"
+#include "SceneGraph.h"
+
+//   .         .
+const uint32_t MESH_CACHE_VERSION = 13;
+
+//    (.meshcache)
+struct MeshCacheHeader {
+	char magic[4];         // "MSHC"
+	uint32_t version;      // MESH_CACHE_VERSION
+	uint32_t vertexSize;   // sizeof(Vertex)   
+	uint32_t settings;     //  ,    
+	uint32_t conversion;   //    (   ..)
+	uint32_t instanceCount;
+	uint64_t sourceHash;   //    
+	uint32_t meshCount;
+	uint32_t textureCount;
+	uint32_t meshletCount;
+	uint32_t nodeCount;
+	uint64_t entriesOffset;  // MeshCacheEntry[meshCount]
+	uint64_t texturesOffset; // MeshCacheTexture[textureCount]
+	uint64_t stringsOffset;  //     
+	uint64_t stringsSize;
+	uint64_t meshletsOffset; // Meshlet[meshletCount]
+	uint64_t nodesOffset;    // MeshCacheNode[nodeCount]
+	uint64_t instancesOffset; // MeshInstance[instanceCount]
+	uint64_t fileSize;
+};
+
+//    :      ,   
+struct MeshCacheEntry {
+	uint64_t vertexOffset;
+	uint64_t indexOffset;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	uint32_t firstTexture; //    MeshCacheTexture
+	uint32_t textureCount;
+	uint32_t vertexFormat; // VertexFormat  
+	uint32_t indexSize;    // 2  4   
+	float color[3];
+	float boundsMin[3];
+	float boundsMax[3];
+	float sphereCenter[3];
+	float sphereRadius;
+	float acmrBefore, atvrBefore; //   ,   
+	float acmrAfter, atvrAfter;
+	float overdrawBefore, overdrawAfter; // 0   
+	uint32_t verticesBeforeWeld;     // 0    
+	uint32_t lodCount;               // 0      
+	MeshLod lods[MAX_MESH_LODS];     //     
+	uint32_t firstMeshlet;           //    Meshlet
+	uint32_t meshletCount;
+	uint64_t contentHash;            // MeshData::computeContentHash
+};
+
+//       SceneGraph:   
+struct MeshCacheNode {
+	uint32_t parent;  // SceneGraph::NO_PARENT  
+	float local[16];  //  ,    glm::mat4
+};
+
+//     (   )
+struct MeshCacheTexture {
+	uint32_t typeOffset;
+	uint32_t typeLength;
+	uint32_t pathOffset;
+	uint32_t pathLength;
+};
+
+//    ,     .
+//       ,  
+//   GPU   ,  Assimp.
+class MeshCache
+{
+public:
+	//       
+	static std::string cachePathFor(const std::string& sourcePath);
+
+	// FNV-1a   ; ok = false,    
+	static uint64_t hashFile(const std::string& path, bool& ok);
+
+	//     CPU- ,     
+	static bool write(const std::string& cachePath, uint64_t sourceHash, uint32_t settings,
+		uint32_t conversion, const std::vector<MeshData>& meshes, const std::vector<MeshInstance>& instances,
+		const SceneGraph& graph);
+
+	//  ; false    ,    
+	bool open(const std::string& cachePath, uint64_t sourceHash, uint32_t settings, uint32_t conversion);
+
+	size_t getMeshCount() const;
+	const MeshCacheEntry& getEntry(size_t mesh) const;
+	const void* getVertices(size_t mesh) const; //   entry.vertexFormat
+	const void* getIndices(size_t mesh) const; //  entry.indexSize   
+	const Meshlet* getMeshlets(size_t mesh) const; // entry.meshletCount 
+	//       SceneGraph::addNode
+	size_t getNodeCount() const;
+	const MeshCacheNode& getNode(size_t node) const;
+	//     
+	size_t getInstanceCount() const;
+	const MeshInstance* getInstances() const { return m_instances; }
+
+	std::string getTextureType(size_t mesh, size_t texture) const;
+	std::string getTexturePath(size_t mesh, size_t texture) const;
+
+private:
+	MappedFile m_file;
+
+	const MeshCacheHeader* m_header = nullptr;
+	const MeshCacheEntry* m_entries = nullptr;
+	const MeshCacheTexture* m_textures = nullptr;
+	const Meshlet* m_meshlets = nullptr;
+	const MeshCacheNode* m_nodes = nullptr;
+	const MeshInstance* m_instances = nullptr;
+	const char* m_strings = nullptr;
+};
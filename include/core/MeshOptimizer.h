@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Mesh.h"
+
+//  FIFO- ,    ACMR  ATVR.
+// 16      GPU,    .
+const unsigned int VERTEX_CACHE_ANALYZE_SIZE = 16;
+
+//  FIFO-      
+VertexCacheStats analyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+	unsigned int cacheSize = VERTEX_CACHE_ANALYZE_SIZE);
+
+//        
+// (  : LRU- ,          )
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+//        ,     VBO .
+// ,       , .    VertexFormat.
+void optimizeVertexFetch(MeshData& data);
+
+//      32- ;  ACMR/ATVR     data
+void optimizeMesh(MeshData& data);
+
+//   ACMR      :
+// 1.05    ,       ~5%
+const float OVERDRAW_CACHE_THRESHOLD = 1.05f;
+
+//  :        6   .
+//     /   (1   ); 0   .
+float analyzeOverdraw(const MeshData& data);
+
+//            , 
+//  ,    ,     
+void optimizeOverdraw(std::vector<unsigned int>& indices, const MeshData& data,
+	float threshold = OVERDRAW_CACHE_THRESHOLD);
+
+//  ,   ;        cacheAfter.
+//   optimizeMesh    .
+void optimizeMeshOverdraw(MeshData& data, float threshold = OVERDRAW_CACHE_THRESHOLD);
+
+class ThreadPool;
+
+//      convertMeshes       ,    
+const size_t WELD_PARALLEL_VERTICES = size_t(1) << 18;
+
+//  :   ,  .
+//      (fnv1aWords);  positionEpsilon > 0  
+//      ,  ,   , .
+//          .
+//  pool ,  (    )    ;
+//   pool     .   .
+//       data.verticesBeforeWeld,   .
+size_t weldVertices(MeshData& data, float positionEpsilon = 0.0f, ThreadPool* pool = nullptr);
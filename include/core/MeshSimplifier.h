@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Mesh.h"
+
+//     LOD     
+const float LOD_MAX_ERROR = 0.05f;
+
+//   indices (32-    data)  
+//    (GarlandHeckbert).    ,   :
+//      ,   LOD    VBO.
+//       (    )  .
+//   targetIndexCount         maxError
+// (  ); resultError     .
+std::vector<unsigned int> simplifyMesh(const MeshData& data, const std::vector<unsigned int>& indices,
+	size_t targetIndexCount, float maxError, float& resultError);
+
+//  LOD:     ,     LOD_MAX_ERROR.
+//    data.indices     ,    data.lods.
+//     ( 0  )   compactIndices.
+void generateLods(MeshData& data);
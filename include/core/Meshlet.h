@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+struct MeshData;
+
+//   : 64   124      mesh shader,
+//          
+const unsigned int MESHLET_MAX_VERTICES = 64;
+const unsigned int MESHLET_MAX_TRIANGLES = 124;
+
+//         .
+//      .
+struct Meshlet {
+	float center[3];   //     
+	float radius;
+	float coneAxis[3]; //  :      
+	float coneCutoff;  // 1    ,      
+	uint32_t firstIndex;
+	uint32_t indexCount;
+};
+
+//    
+struct ClusterStats {
+	size_t tested = 0;
+	size_t frustumCulled = 0;
+	size_t backfaceCulled = 0;
+	size_t drawn = 0;
+};
+
+//    ;      
+struct IndexRanges {
+	std::vector<uint32_t> firstIndices;
+	std::vector<uint32_t> indexCounts;
+
+	void clear() { firstIndices.clear(); indexCounts.clear(); }
+	void add(uint32_t firstIndex, uint32_t indexCount);
+	bool empty() const { return firstIndices.empty(); }
+};
+
+//           (   )
+//        .    ,  .
+void buildMeshlets(MeshData& data);
+
+//     :     
+//      ,    
+class ClusterCuller
+{
+public:
+	// modelViewProjection  modelView      
+	ClusterCuller(const glm::mat4& modelViewProjection, const glm::mat4& modelView, bool backfaceCulling);
+
+	//          
+	bool isVisible(const glm::vec3& center, float radius) const;
+
+	//  ranges     
+	void cull(const Meshlet* meshlets, size_t count, IndexRanges& ranges, ClusterStats& stats) const;
+
+private:
+	glm::vec4 m_planes[6];      // ,    
+	glm::vec3 m_cameraPosition; //   
+	bool m_backfaceCulling;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "Model.h"
+
+//      .
+// ,        ,
+//   GPU        .
+class ModelLoader
+{
+public:
+	ModelLoader() = default;
+	~ModelLoader();
+
+	ModelLoader(const ModelLoader&) = delete;
+	ModelLoader& operator=(const ModelLoader&) = delete;
+
+	//  ; ,     .
+	// reuseBuffers     :     GPU
+	//   (Model::setBufferDonor)
+	void start(const std::string& path, const ImportOptions& options, bool reuseBuffers = false);
+
+	//  ;    ( )  .
+	//  reuseBuffers      GPU:        
+	void cancel();
+
+	//      GL.
+	// current  ,   .  CPU- ,
+	// current   ,         GPU.
+	//   ,     .
+	//  true,  current  .
+	bool update(Model*& current, double budgetMs);
+
+	//     ,    (  ).
+	//     GL      (glfwTerminate);
+	//     ,  shutdown  .
+	void shutdown();
+
+	bool isBusy() const { return m_state != State::Idle; }
+	ImportStage getStage() const { return m_progress.stage; }
+	float getStageProgress() const { return m_progress.fraction; }
+	const char* getStageName() const;
+
+private:
+	enum class State { Idle, Importing, Uploading };
+
+	State m_state = State::Idle;
+
+	std::thread m_thread; //  CPU-
+	ImportProgress m_progress;
+	std::atomic<bool> m_cpuDone{ false };
+	std::atomic<bool> m_cpuOk{ false };
+	bool m_reuseBuffers = false;
+
+	Model* m_model = nullptr;    //  
+	Model* m_previous = nullptr; // ,      
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Mesh.h"
+
+//   OBJ  
+struct ObjLoadStats {
+	size_t bytes = 0;          //  
+	size_t chunks = 0;         // ,  
+	unsigned int threads = 0;
+	double parseMs = 0.0;      //    
+	double buildMs = 0.0;      //  ,     MeshData
+};
+
+//  Wavefront OBJ/MTL  Assimp     (  ).
+//           ;  
+//  (  std::from_chars,       ),
+//  :         .
+//
+//      (  , )    .
+//   ,  aiProcess_Triangulate, V  
+// ,  aiProcess_FlipUVs.    Assimp,     
+//  ,    v/vt/vn     .
+//
+//       ( )   false
+//    reason,     Assimp.
+bool loadObj(const std::string& path, std::vector<MeshData>& meshes, std::string& reason,
+	unsigned int threads = 0, ObjLoadStats* stats = nullptr);
+
+//  .obj   ,   
+bool isObjPath(const std::string& path);
+
+//     mtllib  path     ,
+//  ,   .   ,   :
+//        
+std::vector<std::string> objMaterialLibraries(const std::string& path);
+
+//   OBJ   megabytes :   v/vt/vn,    .
+//      .
+bool writeBenchmarkObj(const std::string& path, size_t megabytes);
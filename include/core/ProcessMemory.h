@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+//         :   
+//        
+
+//   (resident set) , ; 0    
+size_t residentBytes();
+
+//      , ; 0    
+size_t peakResidentBytes();
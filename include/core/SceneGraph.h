@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+//      : ,    ,  .
+//           ,   
+//    [node, getSubtreeEnd(node)).    
+//   ,   setLocal     .
+class SceneGraph
+{
+public:
+	static const uint32_t NO_PARENT = 0xFFFFFFFFu;
+
+	void clear();
+	void reserve(size_t count);
+
+	//     local. parent  NO_PARENT    ,  
+	//      (     ).    
+	//     NO_PARENT.
+	uint32_t addNode(uint32_t parent, const glm::mat4& local);
+
+	size_t getNodeCount() const { return m_parents.size(); }
+	uint32_t getParent(uint32_t node) const { return m_parents[node]; }
+	const glm::mat4& getLocal(uint32_t node) const { return m_local[node]; }
+	//          update()
+	const glm::mat4& getWorld(uint32_t node) const { return m_world[node]; }
+	uint32_t getSubtreeEnd(uint32_t node) const { return m_subtreeEnds[node]; }
+
+	//   ;       update()
+	void setLocal(uint32_t node, const glm::mat4& local);
+	bool isDirty() const { return m_structureChanged || !m_dirtyRoots.empty(); }
+
+	//      ( addNode  );
+	//    
+	size_t update();
+	//           benchmarkSceneGraph
+	size_t updateAll();
+
+private:
+	std::vector<uint32_t> m_parents;
+	std::vector<uint32_t> m_subtreeEnds;
+	std::vector<glm::mat4> m_local;
+	std::vector<glm::mat4> m_world;
+	std::vector<uint8_t> m_dirty;       // setLocal   update()
+	std::vector<uint32_t> m_dirtyRoots; //    : update    
+	std::vector<uint32_t> m_openPath;   //         
+	bool m_structureChanged = false;    //  :      
+
+	void updateRange(uint32_t begin, uint32_t end);
+};
+
+//    :    nodes     animated 
+struct SceneGraphBenchmark {
+	size_t nodes = 0;
+	unsigned int animated = 0;
+	unsigned int frames = 0;
+	size_t updatedPerFrame = 0; //    
+	double incrementalMs = 0.0; // update()  
+	double fullMs = 0.0;        // updateAll()  
+};
+
+//    (      CAD)     ;
+//    
+SceneGraphBenchmark benchmarkSceneGraph(size_t nodeCount, unsigned int animatedNodes, unsigned int frames);
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//   .
+//
+// ImportScratch            .
+// ScratchScope          
+// monotonic_buffer_resource   :      
+//   scratchResource(),    ,     
+//           .
+//     ,   ImportScratch.
+//
+//  ScratchScope scratchResource()   ,     
+// std::pmr-     (,    UI).
+
+//      
+std::pmr::memory_resource* scratchResource();
+
+//  :     
+template <class T>
+using ScratchVector = std::pmr::vector<T>;
+
+class ImportScratch
+{
+public:
+	ImportScratch() = default;
+
+	ImportScratch(const ImportScratch&) = delete;
+	ImportScratch& operator=(const ImportScratch&) = delete;
+
+	//   ;    
+	std::pmr::memory_resource* threadPool();
+
+	//           
+	size_t getPeakBytes() const { return m_upstream.peak; }
+
+private:
+	//   :       
+	class CountingResource : public std::pmr::memory_resource
+	{
+	public:
+		std::atomic<size_t> current{ 0 };
+		std::atomic<size_t> peak{ 0 };
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+	};
+
+	CountingResource m_upstream; //  :   
+	std::mutex m_mutex;
+	std::unordered_map<std::thread::id, std::unique_ptr<std::pmr::unsynchronized_pool_resource>> m_pools;
+};
+
+// ,         scratch.
+// nullptr   ,       .
+class ScratchScope
+{
+public:
+	explicit ScratchScope(ImportScratch* scratch);
+	//  :     ,      .
+	//     ,       .
+	//      .
+	ScratchScope();
+	~ScratchScope();
+
+	ScratchScope(const ScratchScope&) = delete;
+	ScratchScope& operator=(const ScratchScope&) = delete;
+
+private:
+	std::optional<std::pmr::monotonic_buffer_resource> m_arena;
+	std::pmr::memory_resource* m_previous;
+	std::pmr::memory_resource* m_previousPool;
+};
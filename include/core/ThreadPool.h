@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//     CPU- .
+//     OpenGL:     gl*.
+class ThreadPool
+{
+public:
+	// threadCount = 0     
+	explicit ThreadPool(unsigned int threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	unsigned int getThreadCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+	//    
+	void submit(std::function<void()> task);
+
+	// ,       
+	void wait();
+
+	//  body(i)  i  [0, count)       .
+	//   ,       .
+	void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+	//    (  1)
+	static unsigned int hardwareThreads();
+
+private:
+	void workerLoop();
+
+	std::vector<std::thread> m_workers;
+	std::deque<std::function<void()>> m_tasks;
+
+	std::mutex m_mutex;
+	std::condition_variable m_taskReady; //     
+	std::condition_variable m_idle; //      
+
+	size_t m_active = 0; //     
+	bool m_stop = false;
+};
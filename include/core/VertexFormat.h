@@ -0,0 +1,122 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+#define MAX_BONE_INFLUENCE 4
+
+//   .     ,    aiMesh:
+// ,          ,  VBO  .
+//        .
+enum class VertexFormat : uint32_t {
+	Full = 0,           // Vertex:   , 88 
+	Packed = 1,         // PackedVertex:  ,   UV, 16 
+	Tangent = 2,        // TangentVertex: , , UV, , 56 
+	Static = 3,         // StaticVertex: , , UV, 32 
+	PositionNormal = 4, // PositionNormalVertex:  UV, 24 
+};
+
+const unsigned int VERTEX_FORMAT_COUNT = 5;
+
+//         
+struct Vertex {
+	glm::vec3 Position;
+	glm::vec3 Normal;
+	glm::vec2 TexCoords;
+	glm::vec3 Tangent;
+	glm::vec3 Bitangent;
+
+	int m_BoneIDs[MAX_BONE_INFLUENCE];
+	float m_Weights[MAX_BONE_INFLUENCE];
+};
+
+//     
+struct TangentVertex {
+	glm::vec3 Position;
+	glm::vec3 Normal;
+	glm::vec2 TexCoords;
+	glm::vec3 Tangent;
+	glm::vec3 Bitangent;
+};
+
+//     
+struct StaticVertex {
+	glm::vec3 Position;
+	glm::vec3 Normal;
+	glm::vec2 TexCoords;
+};
+
+//      (  CAD)
+struct PositionNormalVertex {
+	glm::vec3 Position;
+	glm::vec3 Normal;
+};
+
+//  .
+//   unorm16   ,      snorm16,
+// UV  half float.     positionOffset + aPos * positionScale.
+struct PackedVertex {
+	uint16_t Position[3];
+	uint16_t Padding;      //    4 
+	int16_t Normal[2];
+	uint16_t TexCoords[2];
+};
+
+//            
+//    aiMesh    VAO
+template <class V> struct VertexTraits;
+
+template <> struct VertexTraits<Vertex> {
+	static const VertexFormat format = VertexFormat::Full;
+	static const bool quantized = false, texCoords = true, tangents = true, bones = true;
+};
+
+template <> struct VertexTraits<TangentVertex> {
+	static const VertexFormat format = VertexFormat::Tangent;
+	static const bool quantized = false, texCoords = true, tangents = true, bones = false;
+};
+
+template <> struct VertexTraits<StaticVertex> {
+	static const VertexFormat format = VertexFormat::Static;
+	static const bool quantized = false, texCoords = true, tangents = false, bones = false;
+};
+
+template <> struct VertexTraits<PositionNormalVertex> {
+	static const VertexFormat format = VertexFormat::PositionNormal;
+	static const bool quantized = false, texCoords = false, tangents = false, bones = false;
+};
+
+template <> struct VertexTraits<PackedVertex> {
+	static const VertexFormat format = VertexFormat::Packed;
+	static const bool quantized = true, texCoords = true, tangents = false, bones = false;
+};
+
+//       : ,
+//    ,     vertexSize(format)
+static_assert(offsetof(Vertex, Position) == 0 && offsetof(TangentVertex, Position) == 0 &&
+	offsetof(StaticVertex, Position) == 0 && offsetof(PositionNormalVertex, Position) == 0,
+	"Position must be the first vertex attribute");
+
+//  f(static_cast<V*>(nullptr))     format.
+//      ,   f     .
+// false    (,   ).
+template <class F>
+bool withVertexType(VertexFormat format, F&& f)
+{
+	switch (format)
+	{
+	case VertexFormat::Full:           f(static_cast<Vertex*>(nullptr)); return true;
+	case VertexFormat::Packed:         f(static_cast<PackedVertex*>(nullptr)); return true;
+	case VertexFormat::Tangent:        f(static_cast<TangentVertex*>(nullptr)); return true;
+	case VertexFormat::Static:         f(static_cast<StaticVertex*>(nullptr)); return true;
+	case VertexFormat::PositionNormal: f(static_cast<PositionNormalVertex*>(nullptr)); return true;
+	}
+	return false;
+}
+
+//     ; 0   
+size_t vertexSize(VertexFormat format);
+
+//    
+const char* vertexFormatName(VertexFormat format);
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Mesh.h"
+
+//     
+struct QuantizationError {
+	float position = 0.0f;      //   
+	float normalDegrees = 0.0f; //      
+	float texCoord = 0.0f;      //   UV
+};
+
+//   UV  half float:   1024x1024.
+// Half float     |uv| < 2        float.
+const float MAX_PACKED_TEXCOORD_ERROR = 0.5f / 1024.0f;
+
+//       [-1, 1]^2  
+glm::vec2 octEncode(const glm::vec3& n);
+glm::vec3 octDecode(const glm::vec2& e);
+
+//   ; invExtent = 1 / (boundsMax - boundsMin), 0   
+PackedVertex packVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& texCoords,
+	const glm::vec3& boundsMin, const glm::vec3& invExtent);
+
+//  ,     (  )
+glm::vec3 unpackPosition(const PackedVertex& vertex, const glm::vec3& boundsMin, const glm::vec3& extent);
+glm::vec3 unpackNormal(const PackedVertex& vertex);
+glm::vec2 unpackTexCoords(const PackedVertex& vertex);
+
+//    VertexFormat::Packed.      ;
+//  UV    MAX_PACKED_TEXCOORD_ERROR,     .
+//    :    .  GL    .
+bool packMeshVertices(MeshData& data, QuantizationError& error);
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+//  glMultiDrawElementsIndirect     GL
+struct DrawElementsIndirectCommand {
+	uint32_t count;
+	uint32_t instanceCount;
+	uint32_t firstIndex;    //  ,   
+	int32_t baseVertex;
+	uint32_t baseInstance;  //          draw ID
+};
+
+//      : texelFetch(drawData, record * DRAW_DATA_TEXELS + n)
+const unsigned int DRAW_DATA_TEXELS = 8;
+struct DrawData {
+	glm::vec4 color;          //   
+	glm::vec4 pickingColor;   // -   
+	glm::vec4 positionOffset; //  PackedVertex;     0
+	glm::vec4 positionScale;  //  1
+	glm::mat4 node;           //     (SceneGraph),  
+};
+
+//  draw ID  VAO  :     baseInstance ,
+//     instanceCount > 1    
+const unsigned int DRAW_ID_ATTRIBUTE = 7;
+
+//  DrawData    (samplerBuffer drawData).    
+// IndirectDraw  draw ID,  glDrawElementsInstanced  instanceBase + gl_InstanceID 
+//       multi-draw indirect.    GL.
+class DrawDataBuffer
+{
+public:
+	DrawDataBuffer() = default;
+	~DrawDataBuffer();
+
+	DrawDataBuffer(const DrawDataBuffer&) = delete;
+	DrawDataBuffer& operator=(const DrawDataBuffer&) = delete;
+
+	//          unit
+	void upload(const std::vector<DrawData>& drawData, unsigned int unit);
+
+private:
+	unsigned int m_buffer = 0;
+	unsigned int m_texture = 0;
+	size_t m_capacity = 0; //   ,      
+};
+
+//      GL_DRAW_INDIRECT_BUFFER:    
+//   VAO,        .   
+//  DrawDataBuffer      draw ID.
+//    3.3,  glad     3.3: glMultiDrawElementsIndirect
+// (GL 4.3  ARB_multi_draw_indirect)    loadFunctions.
+//       GL.
+class IndirectDraw
+{
+public:
+	//  gladLoadGLLoader,   . false    ,    
+	static bool loadFunctions(GLADloadproc load);
+	static bool isSupported();
+
+	IndirectDraw() = default;
+	~IndirectDraw();
+
+	IndirectDraw(const IndirectDraw&) = delete;
+	IndirectDraw& operator=(const IndirectDraw&) = delete;
+
+	//  :    Draw
+	void clear() { m_commands.clear(); }
+	void addCommand(const DrawElementsIndirectCommand& command) { m_commands.push_back(command); }
+	size_t getCommandCount() const { return m_commands.size(); }
+
+	//  ;  DrawData  DrawDataBuffer
+	void upload();
+
+	//  [firstCommand, firstCommand + count)  ; VAO  
+	void draw(unsigned int indexType, size_t firstCommand, size_t count) const;
+
+private:
+	std::vector<DrawElementsIndirectCommand> m_commands;
+	unsigned int m_commandBuffer = 0;
+	size_t m_commandCapacity = 0; //   ,      
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "VertexFormat.h"
+
+class Mesh;
+
+//    :  VBO  VAO    , 
+//   ,   EBO   .     
+//  base vertex,         .
+//  VAO    ,     :   .
+//       GL.
+class SharedGeometry
+{
+public:
+	SharedGeometry() = default;
+	~SharedGeometry();
+
+	SharedGeometry(const SharedGeometry&) = delete;
+	SharedGeometry& operator=(const SharedGeometry&) = delete;
+
+	//        GPU (glCopyBufferSubData),  
+	//       . CPU-   .
+	//  VAO   DRAW_ID_ATTRIBUTE    DrawData  IndirectDraw,
+	//  0  recordCount - 1 (    ,   ).
+	bool build(std::vector<Mesh>& meshes, size_t recordCount);
+
+	// VAO ; 0     
+	unsigned int getVAO(VertexFormat format) const { return m_vaos[static_cast<unsigned int>(format)]; }
+
+	size_t getVertexBytes() const { return m_vertexBytes; }
+	size_t getIndexBytes() const { return m_indexBytes; }
+	unsigned int getVAOCount() const;
+
+private:
+	unsigned int m_vaos[VERTEX_FORMAT_COUNT] = {};
+	unsigned int m_vbos[VERTEX_FORMAT_COUNT] = {};
+	unsigned int m_ebo = 0;
+	unsigned int m_drawIdBuffer = 0; //   DrawData   (IndirectDraw)
+	size_t m_vertexBytes = 0;
+	size_t m_indexBytes = 0;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+//  ,  stb_image
+struct ImageDeleter {
+	void operator()(unsigned char* pixels) const;
+};
+
+// ,   CPU      GPU
+struct DecodedTexture {
+	std::string filename; //    
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	std::unique_ptr<unsigned char, ImageDeleter> pixels;
+	uint64_t contentHash = 0; //   ; 0   
+
+	bool valid() const { return pixels != nullptr; }
+};
+
+//   .   GL      .
+// hashContent      (      ).
+DecodedTexture decodeTexture(const std::string& filename, bool hashContent = false);
+
+//   GL  -; 0     .
+//       OpenGL.
+unsigned int uploadTexture(const DecodedTexture& image);
+
+//    GPU  pixel buffer object.
+//    PBO,  glTexImage2D    ,   
+//    .     PBO "" 
+//   ,  ,  GPU  ,     .
+// -   ,   generateMipmaps  : glGenerateMipmap
+//   glTexImage2D  PBO      .
+//       GL.
+class TextureUploader
+{
+public:
+	TextureUploader() = default;
+	~TextureUploader();
+
+	TextureUploader(const TextureUploader&) = delete;
+	TextureUploader& operator=(const TextureUploader&) = delete;
+
+	//     textureID  image.  generateMipmaps
+	//    -
+	bool upload(unsigned int textureID, const DecodedTexture& image);
+
+	//  - ,    ;    upload.
+	//      
+	void generateMipmaps();
+	bool hasPendingMipmaps() const { return !m_pendingMipmaps.empty(); }
+
+private:
+	unsigned int m_buffer = 0; // PBO,    
+	std::vector<unsigned int> m_pendingMipmaps; //   -
+};
+
+//       ( )
+unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma = false);
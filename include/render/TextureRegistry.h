@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//       GL.
+//        GPU  ,     
+//    ;  ,     .
+//      ,      (    ).
+//  ; release()   glDeleteTextures     GL.
+class TextureRegistry
+{
+public:
+	static TextureRegistry& instance();
+
+	//   : "a/b/../c.png"  "a/c.png"   
+	static std::string canonicalPath(const std::string& path);
+
+	// ,    ;   . 0   .
+	unsigned int acquire(const std::string& key);
+
+	//     ;   key      
+	unsigned int acquireByHash(uint64_t contentHash, const std::string& key);
+
+	//             ; 0   
+	unsigned int find(const std::string& key) const;
+
+	//   key  ,      ,   :
+	// key  references       GL,    .
+	//   id; 0    (        ),
+	//     .   GL     GL.
+	unsigned int detach(const std::string& key, unsigned int references);
+
+	//        id (   )
+	void setContentHash(unsigned int id, uint64_t contentHash);
+
+	//  ,   ;    .
+	// contentHash == 0    .
+	void add(const std::string& key, unsigned int id, uint64_t contentHash = 0);
+
+	//  ;     GL
+	void release(unsigned int id);
+
+	//   GL  
+	size_t size() const;
+
+private:
+	TextureRegistry() = default;
+
+	struct Entry {
+		unsigned int refCount = 0;
+		uint64_t contentHash = 0;
+		std::vector<std::string> keys; //  ,    
+	};
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<unsigned int, Entry> m_entries;        // id  GL -> 
+	std::unordered_map<std::string, unsigned int> m_byPath;   //   -> id
+	std::unordered_map<uint64_t, unsigned int> m_byHash;      //   -> id
+};
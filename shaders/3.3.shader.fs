@@ -3,8 +3,8 @@
 out vec4 FragColor;
 
 in vec2 TexCoords;
+flat in vec3 MeshColor; // objectColor     IndirectDraw
 
-uniform vec3 objectColor;
 uniform sampler2D texture_diffuse1;
 uniform bool useTexture;
 
@@ -17,7 +17,7 @@ void main()
     if (useTexture)
         baseColor = texture(texture_diffuse1, TexCoords);
     else
-        baseColor = vec4(objectColor, 1.0);
+        baseColor = vec4(MeshColor, 1.0);
 
     FragColor = baseColor;
 }
@@ -2,19 +2,62 @@
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoords;
+layout(location = 7) in uint aDrawID; //   drawData (IndirectDraw):   baseInstance 
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
+flat out vec3 MeshColor;
 
 uniform mat4 model;
+uniform mat4 node = mat4(1.0); //     (SceneGraph)
 uniform mat4 view;
 uniform mat4 projection;
 
+//    (PackedVertex);     0, 1  false
+uniform vec3 positionOffset = vec3(0.0);
+uniform vec3 positionScale = vec3(1.0);
+uniform bool octNormals = false;
+
+uniform vec3 objectColor;
+
+// IndirectDraw:         draw ID,    uniform
+uniform bool useDrawData = false;
+// glDrawElementsInstanced:    instanceBase + gl_InstanceID; -1     uniform
+uniform int instanceBase = -1;
+uniform samplerBuffer drawData; // 8 texel  : ,  picking, , ,  
+
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    vec3 offset = positionOffset;
+    vec3 scale = positionScale;
+    mat4 nodeMatrix = node;
+    MeshColor = objectColor;
+    int record = useDrawData ? int(aDrawID) : instanceBase >= 0 ? instanceBase + gl_InstanceID : -1;
+    if (record >= 0)
+    {
+        record *= 8;
+        MeshColor = texelFetch(drawData, record).rgb;
+        offset = texelFetch(drawData, record + 2).xyz;
+        scale = texelFetch(drawData, record + 3).xyz;
+        nodeMatrix = mat4(texelFetch(drawData, record + 4), texelFetch(drawData, record + 5),
+            texelFetch(drawData, record + 6), texelFetch(drawData, record + 7));
+    }
+
+    vec3 position = offset + aPos * scale;
+    vec3 normal = octNormals ? octDecode(aNormal.xy) : aNormal;
+
+    mat4 meshModel = model * nodeMatrix;
+    FragPos = vec3(meshModel * vec4(position, 1.0));
+    Normal = mat3(transpose(inverse(meshModel))) * normal;
     TexCoords = aTexCoords;
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
@@ -1,9 +1,9 @@
 #version 330 core
 out vec4 FragColor;
 
-uniform vec3 objectColor; //    
+flat in vec3 PickingColor; //     
 
 void main()
 {
-    FragColor = vec4(objectColor, 1.0);
+    FragColor = vec4(PickingColor, 1.0);
 }
@@ -1,11 +1,42 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
+layout(location = 7) in uint aDrawID; //   drawData (IndirectDraw)
+
+flat out vec3 PickingColor;
 
 uniform mat4 model;
+uniform mat4 node = mat4(1.0); //     (SceneGraph)
 uniform mat4 view;
 uniform mat4 projection;
 
+//    (PackedVertex)
+uniform vec3 positionOffset = vec3(0.0);
+uniform vec3 positionScale = vec3(1.0);
+
+uniform vec3 objectColor; //     
+
+// IndirectDraw:  picking       draw ID;
+// glDrawElementsInstanced   instanceBase + gl_InstanceID,     
+uniform bool useDrawData = false;
+uniform int instanceBase = -1;
+uniform samplerBuffer drawData;
+
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vec3 offset = positionOffset;
+    vec3 scale = positionScale;
+    mat4 nodeMatrix = node;
+    PickingColor = objectColor;
+    int record = useDrawData ? int(aDrawID) : instanceBase >= 0 ? instanceBase + gl_InstanceID : -1;
+    if (record >= 0)
+    {
+        record *= 8;
+        PickingColor = texelFetch(drawData, record + 1).rgb;
+        offset = texelFetch(drawData, record + 2).xyz;
+        scale = texelFetch(drawData, record + 3).xyz;
+        nodeMatrix = mat4(texelFetch(drawData, record + 4), texelFetch(drawData, record + 5),
+            texelFetch(drawData, record + 6), texelFetch(drawData, record + 7));
+    }
+
+    gl_Position = projection * view * model * nodeMatrix * vec4(offset + aPos * scale, 1.0);
 }
@@ -32,6 +32,9 @@
 
 // Потоковый ввод/вывод (логирование, отладка)
 #include <iostream>
+#include <cstring>
+// Временная папка для сгенерированных файлов замеров
+#include <filesystem>
 
 // =======================
 // ImGui — пользовательский интерфейс
@@ -67,6 +70,17 @@
 #include <assimp/postprocess.h>
 
 #include <Model.h>
+// ModelLoader — фоновая загрузка модели без блокировки окна
+#include "ModelLoader.h"
+// HotReload — перезагрузка изменённых на диске файлов модели
+#include "HotReload.h"
+// IndirectDraw — отрисовка модели командами из буфера, если контекст это умеет
+#include "IndirectDraw.h"
+// ObjLoader — генерация большого OBJ для замера загрузчиков
+#include "ObjLoader.h"
+
+// Модель, которую загружает кнопка в UI
+const char* MODEL_PATH = "assets/models/Model3D.glb";
 
 unsigned int pickingFBO = 0;
 unsigned int pickingTexture = 0;
@@ -138,6 +152,21 @@ Arcball arcball(SCR_WIDTH, SCR_HEIGHT);
 
 Model* loadedModel = nullptr; // указатель на модель
 
+// Сколько миллисекунд за кадр можно тратить на загрузку мешей в GPU при фоновой загрузке
+const double uploadBudgetMs = 4.0;
+
+// Подбирает масштаб, чтобы модель целиком помещалась в кадр
+void fitModelScale(Model* model)
+{
+	if (!model) return;
+
+	glm::vec3 modelSize = model->getSize();
+	float maxDimension = glm::max(glm::max(modelSize.x, modelSize.y), modelSize.z);
+	if (maxDimension <= 0.0f) maxDimension = 1.0f;
+	float scaleFactor = 1.0f / maxDimension;
+	model->setScale(scaleFactor);
+}
+
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 {
 	// GLFW передаёт смещение колеса мыши:
@@ -153,8 +182,74 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 	fov = glm::clamp(fov, minFov, maxFov);
 }
 
-int main()
+// Проверка IndirectDraw без интерфейса (--check-indirect [модель]): модель с общими буферами
+// рисуется циклом по мешам и командами из буфера, пиксели сравниваются (Model::compareIndirectDraw).
+// Окно скрыто, так что проверка идёт и без экрана, например на Mesa:
+//   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run OPENGL_2.0 --check-indirect
+// Код возврата 0 — изображения совпали.
+int runIndirectDrawCheck(const char* path)
+{
+	glEnable(GL_DEPTH_TEST);
+
+	Shader shader("shaders/3.3.shader.vs", "shaders/3.3.shader.fs");
+	Shader picking("shaders/picking.vs", "shaders/picking.fs");
+	shader.use();
+	shader.setInt("texture1", 0);
+
+	ImportOptions options;
+	options.sharedBuffers = true; // IndirectDraw работает только с общими буферами
+	options.useCache = false;
+	Model model(path, options);
+	fitModelScale(&model);
+
+	glm::mat4 view = glm::lookAt(glm::vec3(0, 0, 3), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
+	glm::mat4 projection = glm::perspective(glm::radians(fov), (float)SCR_WIDTH / SCR_HEIGHT, 0.1f, 100.0f);
+	shader.setMat4("view", view);
+	shader.setMat4("projection", projection);
+	picking.use();
+	picking.setMat4("view", view);
+	picking.setMat4("projection", projection);
+	model.setCamera(view, projection, static_cast<float>(SCR_HEIGHT));
+
+	IndirectDrawCheck check = model.compareIndirectDraw(shader, picking, SCR_WIDTH, SCR_HEIGHT);
+	return check.passed() ? 0 : 1;
+}
+
+// Проверка выделений кучи (--check-allocations [модель]): модель читается через Assimp без кэша,
+// и у каждого меша processMesh должен сделать ровно expectedProcessMeshAllocations выделений.
+// Только чтение на CPU — ни окна, ни контекста GL не нужно. Счётчик есть в сборке
+// с ALLOCATION_COUNTER (конфигурации Debug). Код возврата 0 — все меши совпали.
+int runAllocationCheck(const char* path)
 {
+#ifdef ALLOCATION_COUNTER
+	ImportOptions options;
+	options.useCache = false;
+	options.nativeGltf = false; // выделения считаются только в processMesh — пути Assimp
+	options.nativeObj = false;
+	Model model(options);
+	if (!model.importCPU(path))
+		return 1;
+
+	const ImportStats& stats = model.getImportStats();
+	const bool passed = stats.allocationsMax > 0 && stats.allocationMismatches == 0;
+	std::cout << "Allocation check (" << path << "): " << stats.allocationsMin << ".." << stats.allocationsMax
+		<< " heap allocations per mesh, unexpected in " << stats.allocationMismatches << " meshes"
+		<< (passed ? "" : " - FAILED") << std::endl;
+	return passed ? 0 : 1;
+#else
+	std::cout << "Allocation check: built without ALLOCATION_COUNTER, use the Debug configuration" << std::endl;
+	return 1;
+#endif
+}
+
+int main(int argc, char** argv)
+{
+	// без окна и GL: выход сразу после проверки
+	if (argc > 1 && std::strcmp(argv[1], "--check-allocations") == 0)
+		return runAllocationCheck(argc > 2 ? argv[2] : MODEL_PATH);
+
+	const bool checkIndirect = argc > 1 && std::strcmp(argv[1], "--check-indirect") == 0;
+
 	// Инициализация GLFW — библиотеки для создания окна и работы с контекстом OpenGL
 	glfwInit();
 	// Устанавливаем требуемую версию OpenGL (3.3)
@@ -162,6 +257,9 @@ int main()
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3); 
 	// Указываем использование Core Profile (без устаревших функций)
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE); 
+	// для проверки IndirectDraw окно не показывается
+	if (checkIndirect)
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 
 	// Создаем окно с указанными размерами и заголовком
 	GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "DEMO", NULL, NULL);
@@ -186,6 +284,17 @@ int main()
 		return -1;
 	}
 
+	// glMultiDrawElementsIndirect — не из 3.3, загружается отдельно; без неё модели рисуются циклом по мешам
+	IndirectDraw::loadFunctions((GLADloadproc)glfwGetProcAddress);
+
+	if (checkIndirect)
+	{
+		// модель и шейдеры удаляются внутри, пока контекст ещё жив
+		int result = runIndirectDrawCheck(argc > 2 ? argv[2] : MODEL_PATH);
+		glfwTerminate();
+		return result;
+	}
+
 	// Инициализация ImGui для графического интерфейса
 	IMGUI_CHECKVERSION();
 	ImGui::CreateContext();
@@ -207,6 +316,11 @@ int main()
 	// Создаем UI слой для редактора
 	EditorUI editorUI;
 
+	// Фоновый загрузчик моделей
+	ModelLoader modelLoader;
+	// Слежение за файлами загруженной модели
+	HotReload hotReload;
+
 	// Включаем тест глубины, чтобы корректно отображались пересекающиеся объекты
 	glEnable(GL_DEPTH_TEST);
 
@@ -314,32 +428,89 @@ int main()
 
 		if (editorUI.loadModelRequested)
 		{
-			if (loadedModel) delete loadedModel;
-			loadedModel = new Model("assets/models/Model3D.obj");
-
-			glm::vec3 modelSize = loadedModel->getSize();
-			float maxDimension = glm::max(glm::max(modelSize.x, modelSize.y), modelSize.z);
-			if (maxDimension <= 0.0f) maxDimension = 1.0f;
-			float scaleFactor = 1.0f / maxDimension;
-			loadedModel->setScale(scaleFactor);
+			if (editorUI.backgroundLoading)
+			{
+				// прежняя модель рисуется, пока новая читается в фоне
+				modelLoader.start(MODEL_PATH, editorUI.importOptions);
+			}
+			else if (!modelLoader.isBusy())
+			{
+				if (loadedModel) delete loadedModel;
+				loadedModel = new Model(MODEL_PATH, editorUI.importOptions);
+				fitModelScale(loadedModel);
+			}
 
 			editorUI.loadModelRequested = false;
 		}
 
+		if (editorUI.compareLoadersRequested)
+		{
+			editorUI.lastComparison = Model::compareLoaders(MODEL_PATH, 20);
+			editorUI.compareLoadersRequested = false;
+		}
+
+		if (editorUI.benchmarkObjRequested)
+		{
+			// сетка нужного размера во временной папке; прогонов мало — файл может быть большим
+			std::string objPath = (std::filesystem::temp_directory_path() / "benchmark.obj").string();
+			if (writeBenchmarkObj(objPath, static_cast<size_t>(editorUI.benchmarkObjMegabytes)))
+				editorUI.lastComparison = Model::compareLoaders(objPath, 3);
+			else
+				std::cerr << "ERROR::OBJ::Failed to write " << objPath << std::endl;
+			editorUI.benchmarkObjRequested = false;
+		}
+
+		if (editorUI.benchmarkImportRequested)
+		{
+			editorUI.lastImportBenchmark = Model::benchmarkImport(MODEL_PATH, editorUI.importOptions, 10);
+			editorUI.benchmarkImportRequested = false;
+		}
+
+		if (editorUI.cancelLoadRequested)
+		{
+			modelLoader.cancel();
+			editorUI.cancelLoadRequested = false;
+		}
+
+		// догружаем меши в GPU; при смене модели пересчитываем масштаб
+		if (modelLoader.update(loadedModel, uploadBudgetMs))
+			fitModelScale(loadedModel);
+
+		// файлы модели изменились на диске: текстуры — сразу, модель — через modelLoader
+		if (editorUI.hotReload)
+		{
+			hotReload.update(loadedModel, MODEL_PATH, modelLoader, editorUI.importOptions);
+			editorUI.hotReloadStats = hotReload.getStats();
+		}
+
 		if (loadedModel)
 		{
 			loadedModel->setRotationMatrix(arcball.getRotationMatrix());
+			loadedModel->setCamera(view, projection, static_cast<float>(gHeight));
 			loadedModel->Draw(ourShader);
+
+			// замер по кнопке в UI: повторяет Draw с тем же состоянием кадра
+			if (editorUI.benchmarkDrawRequested)
+			{
+				editorUI.lastBenchmark = loadedModel->benchmarkDraw(ourShader, 100);
+				editorUI.benchmarkDrawRequested = false;
+			}
 		}
 
 		// Рендеринг ImGui
 		editorUI.beginFrame();
-		editorUI.render(loadedModel);
+		editorUI.render(loadedModel, modelLoader);
 
 		glfwSwapBuffers(window); // Меняем цветовые буферы местами
 		glfwPollEvents(); // Обрабатываем события ввода
 	}
 
+	// Модели удаляют свои текстуры и буферы — пока контекст GL ещё жив
+	hotReload.shutdown();
+	modelLoader.shutdown();
+	delete loadedModel;
+	loadedModel = nullptr;
+
 	// Завершаем работу GLFW и освобождаем ресурсы
 	glfwTerminate();
 	return 0;
@@ -519,14 +690,14 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 
 		glBindFramebuffer(GL_FRAMEBUFFER, 0); // отвязываем FBO
 
-		// Преобразуем RGB обратно в индекс меша
+		// Преобразуем RGB обратно в индекс экземпляра меша
 		unsigned int pickedID = data[0] + (data[1] << 8) + (data[2] << 16) - 1;
 
 		// Проверяем, что индекс валидный
-		if (pickedID < loadedModel->getMeshCount())
+		if (pickedID < loadedModel->getInstanceCount())
 		{
-			loadedModel->selectMesh(pickedID);
-			std::cout << "Selected mesh: " << pickedID << std::endl;
+			loadedModel->selectInstance(pickedID);
+			std::cout << "Selected instance: " << pickedID << " (mesh " << loadedModel->getInstance(pickedID).mesh << ")" << std::endl;
 		}
 	}
 }
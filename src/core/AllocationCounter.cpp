@@ -0,0 +1,76 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef ALLOCATION_COUNTER
+
+namespace
+{
+    //   : operator new    main,    CRT
+    thread_local size_t allocationCount = 0;
+
+    void* allocate(std::size_t size)
+    {
+        ++allocationCount;
+        if (size == 0)
+            size = 1;
+
+        //   operator new: new_handler  bad_alloc
+        for (;;)
+        {
+            if (void* pointer = std::malloc(size))
+                return pointer;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+                throw std::bad_alloc();
+            handler();
+        }
+    }
+}
+
+size_t threadAllocationCount()
+{
+    return allocationCount;
+}
+
+//   ; nothrow     delete    .
+//   (alignas  16)       .
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+#else
+
+size_t threadAllocationCount()
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,182 @@
+#include "Bounds.h"
+#include "Mesh.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define BOUNDS_SSE 1
+#endif
+
+namespace
+{
+    inline glm::vec3 loadPosition(const unsigned char* p)
+    {
+        glm::vec3 position;
+        std::memcpy(&position, p, sizeof(glm::vec3));
+        return position;
+    }
+
+#ifdef BOUNDS_SSE
+    // x, y, z   w   4   .     :
+    //   16      
+    inline __m128 loadWide(const unsigned char* p)
+    {
+        return _mm_loadu_ps(reinterpret_cast<const float*>(p));
+    }
+
+    //  12 , w = 0
+    inline __m128 loadExact(const unsigned char* p)
+    {
+        return _mm_setr_ps(reinterpret_cast<const float*>(p)[0], reinterpret_cast<const float*>(p)[1],
+            reinterpret_cast<const float*>(p)[2], 0.0f);
+    }
+
+    inline glm::vec3 toVec3(__m128 v)
+    {
+        float f[4];
+        _mm_storeu_ps(f, v);
+        return glm::vec3(f[0], f[1], f[2]);
+    }
+#endif
+
+    //  : min/max   , visit(i, p)    (  copyPositions).
+    //       ,   .
+    template <class Visit>
+    void reduceBounds(const unsigned char* p, size_t count, size_t stride,
+        glm::vec3& boundsMin, glm::vec3& boundsMax, Visit visit)
+    {
+        if (count == 0)
+            return;
+
+#ifdef BOUNDS_SSE
+        //       min/max,   w  
+        __m128 lo0 = _mm_set1_ps(FLT_MAX), hi0 = _mm_set1_ps(-FLT_MAX);
+        __m128 lo1 = lo0, hi1 = hi0;
+        const size_t last = count - 1;
+        size_t i = 0;
+        for (; i + 1 < last; i += 2)
+        {
+            const unsigned char* a = p + i * stride;
+            const unsigned char* b = a + stride;
+            __m128 va = loadWide(a);
+            __m128 vb = loadWide(b);
+            lo0 = _mm_min_ps(lo0, va);
+            hi0 = _mm_max_ps(hi0, va);
+            lo1 = _mm_min_ps(lo1, vb);
+            hi1 = _mm_max_ps(hi1, vb);
+            visit(i, a);
+            visit(i + 1, b);
+        }
+        for (; i <= last; ++i)
+        {
+            const unsigned char* a = p + i * stride;
+            __m128 va = i < last ? loadWide(a) : loadExact(a);
+            lo0 = _mm_min_ps(lo0, va);
+            hi0 = _mm_max_ps(hi0, va);
+            visit(i, a);
+        }
+        boundsMin = toVec3(_mm_min_ps(lo0, lo1));
+        boundsMax = toVec3(_mm_max_ps(hi0, hi1));
+#else
+        boundsMin = glm::vec3(FLT_MAX);
+        boundsMax = glm::vec3(-FLT_MAX);
+        for (size_t i = 0; i < count; ++i)
+        {
+            glm::vec3 position = loadPosition(p + i * stride);
+            boundsMin = glm::min(boundsMin, position);
+            boundsMax = glm::max(boundsMax, position);
+            visit(i, p + i * stride);
+        }
+#endif
+    }
+}
+
+void positionBounds(const void* positions, size_t count, size_t stride, glm::vec3& boundsMin, glm::vec3& boundsMax)
+{
+    reduceBounds(static_cast<const unsigned char*>(positions), count, stride, boundsMin, boundsMax,
+        [](size_t, const unsigned char*) {});
+}
+
+void copyPositions(const void* positions, size_t count, size_t stride,
+    void* destination, size_t destinationStride, glm::vec3& boundsMin, glm::vec3& boundsMax)
+{
+    //  12 :       
+    unsigned char* out = static_cast<unsigned char*>(destination);
+    reduceBounds(static_cast<const unsigned char*>(positions), count, stride, boundsMin, boundsMax,
+        [out, destinationStride](size_t i, const unsigned char* p)
+        {
+            std::memcpy(out + i * destinationStride, p, sizeof(glm::vec3));
+        });
+}
+
+float boundingRadius(const void* positions, size_t count, size_t stride, const glm::vec3& center)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(positions);
+    float maxDistance2 = 0.0f;
+    size_t i = 0;
+
+#ifdef BOUNDS_SSE
+    //   :   x, y, z  ,     .
+    //      ,      
+    const __m128 cx = _mm_set1_ps(center.x);
+    const __m128 cy = _mm_set1_ps(center.y);
+    const __m128 cz = _mm_set1_ps(center.z);
+    __m128 best = _mm_setzero_ps();
+    for (; i + 4 < count; i += 4)
+    {
+        const unsigned char* a = p + i * stride;
+        __m128 x = loadWide(a);
+        __m128 y = loadWide(a + stride);
+        __m128 z = loadWide(a + 2 * stride);
+        __m128 w = loadWide(a + 3 * stride);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        __m128 dx = _mm_sub_ps(x, cx);
+        __m128 dy = _mm_sub_ps(y, cy);
+        __m128 dz = _mm_sub_ps(z, cz);
+        __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        best = _mm_max_ps(best, d2);
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, best);
+    maxDistance2 = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+
+    for (; i < count; ++i)
+    {
+        glm::vec3 d = loadPosition(p + i * stride) - center;
+        maxDistance2 = std::max(maxDistance2, glm::dot(d, d));
+    }
+    return std::sqrt(maxDistance2);
+}
+
+void transformBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& matrix,
+    glm::vec3& outMin, glm::vec3& outMax)
+{
+    const glm::vec3 center = glm::vec3(matrix * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.0f));
+    const glm::vec3 half = (boundsMax - boundsMin) * 0.5f;
+
+    //    i   |m[j][i]| * half[j]
+    glm::vec3 extent(0.0f);
+    for (int j = 0; j < 3; ++j)
+        extent += glm::abs(glm::vec3(matrix[j])) * half[j];
+
+    outMin = center - extent;
+    outMax = center + extent;
+}
+
+void computeBounds(MeshData& data)
+{
+    const size_t count = data.vertexCount();
+    if (count == 0)
+        return;
+
+    const size_t stride = vertexSize(data.format);
+    positionBounds(data.vertices.data(), count, stride, data.boundsMin, data.boundsMax);
+    data.sphereCenter = (data.boundsMin + data.boundsMax) * 0.5f;
+    data.sphereRadius = boundingRadius(data.vertices.data(), count, stride, data.sphereCenter);
+}
@@ -0,0 +1,192 @@
+#include "FileWatcher.h"
+#include "TextureRegistry.h"
+
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    std::string parentDirectory(const std::string& path)
+    {
+        return std::filesystem::path(path).parent_path().generic_string();
+    }
+}
+
+FileWatcher::~FileWatcher()
+{
+    clear();
+#ifndef _WIN32
+    if (m_fd >= 0)
+        close(m_fd);
+#endif
+}
+
+std::vector<std::string> FileWatcher::poll()
+{
+    readEvents();
+
+    std::vector<std::string> settled;
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = m_changed.begin(); it != m_changed.end();)
+    {
+        if (now - it->second >= std::chrono::milliseconds(FILE_WATCH_SETTLE_MS))
+        {
+            settled.push_back(it->first);
+            it = m_changed.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return settled;
+}
+
+#ifdef _WIN32
+
+bool FileWatcher::watch(const std::string& path)
+{
+    const std::string file = TextureRegistry::canonicalPath(path);
+    const std::string directory = parentDirectory(file);
+
+    if (!m_directories.count(directory))
+    {
+        HANDLE handle = FindFirstChangeNotificationA(directory.c_str(), FALSE,
+            FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            std::cerr << "ERROR::FILE_WATCHER::Cannot watch " << directory << std::endl;
+            return false;
+        }
+        m_directories.emplace(directory, handle);
+    }
+
+    std::error_code error;
+    m_writeTimes[file] = std::filesystem::last_write_time(file, error);
+    m_files.insert(file);
+    return true;
+}
+
+void FileWatcher::clear()
+{
+    for (const auto& directory : m_directories)
+        FindCloseChangeNotification(directory.second);
+    m_directories.clear();
+    m_writeTimes.clear();
+    m_files.clear();
+    m_changed.clear();
+}
+
+void FileWatcher::readEvents()
+{
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto& directory : m_directories)
+    {
+        if (WaitForSingleObject(directory.second, 0) != WAIT_OBJECT_0)
+            continue;
+        FindNextChangeNotification(directory.second);
+
+        //   ,   :     
+        for (auto& written : m_writeTimes)
+        {
+            if (parentDirectory(written.first) != directory.first)
+                continue;
+            std::error_code error;
+            std::filesystem::file_time_type time = std::filesystem::last_write_time(written.first, error);
+            if (error || time == written.second)
+                continue;
+            written.second = time;
+            m_changed[written.first] = now;
+        }
+    }
+}
+
+#else
+
+bool FileWatcher::watch(const std::string& path)
+{
+    const std::string file = TextureRegistry::canonicalPath(path);
+    const std::string directory = parentDirectory(file);
+
+    if (m_fd < 0)
+    {
+        m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_fd < 0)
+        {
+            std::cerr << "ERROR::FILE_WATCHER::inotify_init1 failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+
+    bool watched = false;
+    for (const auto& entry : m_directories)
+        watched = watched || entry.second == directory;
+    if (!watched)
+    {
+        //      
+        int wd = inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (wd < 0)
+        {
+            std::cerr << "ERROR::FILE_WATCHER::Cannot watch " << directory << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        m_directories[wd] = directory;
+    }
+
+    m_files.insert(file);
+    return true;
+}
+
+void FileWatcher::clear()
+{
+    if (m_fd >= 0)
+    {
+        for (const auto& directory : m_directories)
+            inotify_rm_watch(m_fd, directory.first);
+    }
+    m_directories.clear();
+    m_files.clear();
+    m_changed.clear();
+}
+
+void FileWatcher::readEvents()
+{
+    if (m_fd < 0)
+        return;
+
+    const auto now = std::chrono::steady_clock::now();
+    alignas(inotify_event) char buffer[16 * 1024];
+    for (;;)
+    {
+        ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break; // EAGAIN:   
+
+        for (char* p = buffer; p < buffer + length;)
+        {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + event->len;
+
+            auto directory = m_directories.find(event->wd);
+            if (directory == m_directories.end() || event->len == 0)
+                continue;
+            std::string file = directory->second + '/' + event->name;
+            if (m_files.count(file))
+                m_changed[file] = now;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,720 @@
+#include "GltfLoader.h"
+#include "Bounds.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace
+{
+    // ---  JSON:  ,     glTF ---
+
+    struct JsonValue {
+        enum Type { Null, Bool, Number, String, Array, Object };
+
+        Type type = Null;
+        bool boolean = false;
+        double number = 0.0;
+        std::string string;
+        std::vector<JsonValue> items;  //     
+        std::vector<std::string> keys; //   ,   items
+
+        const JsonValue* find(const char* key) const
+        {
+            for (size_t i = 0; i < keys.size(); ++i)
+            {
+                if (keys[i] == key)
+                    return &items[i];
+            }
+            return nullptr;
+        }
+
+        const JsonValue* at(size_t index) const
+        {
+            return type == Array && index < items.size() ? &items[index] : nullptr;
+        }
+
+        // -  -1,        
+        long long index(const char* key) const
+        {
+            const JsonValue* value = find(key);
+            if (!value || value->type != Number || value->number < 0.0 || value->number != double((long long)value->number))
+                return -1;
+            return (long long)value->number;
+        }
+
+        double numberOr(const char* key, double fallback) const
+        {
+            const JsonValue* value = find(key);
+            return value && value->type == Number ? value->number : fallback;
+        }
+    };
+
+    class JsonParser
+    {
+    public:
+        JsonParser(const char* begin, const char* end) : m_pos(begin), m_end(end) {}
+
+        bool parse(JsonValue& value)
+        {
+            return parseValue(value, 0) && (skipSpace(), m_pos == m_end);
+        }
+
+    private:
+        const char* m_pos;
+        const char* m_end;
+
+        static const int MAX_DEPTH = 64;
+
+        void skipSpace()
+        {
+            while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r'))
+                ++m_pos;
+        }
+
+        bool match(const char* literal)
+        {
+            size_t length = std::strlen(literal);
+            if (size_t(m_end - m_pos) < length || std::memcmp(m_pos, literal, length) != 0)
+                return false;
+            m_pos += length;
+            return true;
+        }
+
+        bool parseValue(JsonValue& value, int depth)
+        {
+            skipSpace();
+            if (m_pos == m_end || depth > MAX_DEPTH)
+                return false;
+
+            switch (*m_pos)
+            {
+            case '{': return parseObject(value, depth);
+            case '[': return parseArray(value, depth);
+            case '"': value.type = JsonValue::String; return parseString(value.string);
+            case 't': value.type = JsonValue::Bool; value.boolean = true; return match("true");
+            case 'f': value.type = JsonValue::Bool; value.boolean = false; return match("false");
+            case 'n': value.type = JsonValue::Null; return match("null");
+            default:
+            {
+                // from_chars    :    '.'
+                value.type = JsonValue::Number;
+                std::from_chars_result result = std::from_chars(m_pos, m_end, value.number);
+                if (result.ec != std::errc())
+                    return false;
+                m_pos = result.ptr;
+                return true;
+            }
+            }
+        }
+
+        bool parseObject(JsonValue& value, int depth)
+        {
+            value.type = JsonValue::Object;
+            ++m_pos;
+            skipSpace();
+            if (m_pos < m_end && *m_pos == '}')
+            {
+                ++m_pos;
+                return true;
+            }
+
+            for (;;)
+            {
+                skipSpace();
+                value.keys.emplace_back();
+                if (m_pos == m_end || *m_pos != '"' || !parseString(value.keys.back()))
+                    return false;
+
+                skipSpace();
+                if (m_pos == m_end || *m_pos++ != ':')
+                    return false;
+
+                value.items.emplace_back();
+                if (!parseValue(value.items.back(), depth + 1))
+                    return false;
+
+                skipSpace();
+                if (m_pos == m_end)
+                    return false;
+                if (*m_pos == '}')
+                {
+                    ++m_pos;
+                    return true;
+                }
+                if (*m_pos++ != ',')
+                    return false;
+            }
+        }
+
+        bool parseArray(JsonValue& value, int depth)
+        {
+            value.type = JsonValue::Array;
+            ++m_pos;
+            skipSpace();
+            if (m_pos < m_end && *m_pos == ']')
+            {
+                ++m_pos;
+                return true;
+            }
+
+            for (;;)
+            {
+                value.items.emplace_back();
+                if (!parseValue(value.items.back(), depth + 1))
+                    return false;
+
+                skipSpace();
+                if (m_pos == m_end)
+                    return false;
+                if (*m_pos == ']')
+                {
+                    ++m_pos;
+                    return true;
+                }
+                if (*m_pos++ != ',')
+                    return false;
+            }
+        }
+
+        //   UTF-8; \uXXXX   UTF-8 (  )
+        bool parseString(std::string& out)
+        {
+            ++m_pos;
+            while (m_pos < m_end && *m_pos != '"')
+            {
+                char c = *m_pos++;
+                if (c != '\\')
+                {
+                    out.push_back(c);
+                    continue;
+                }
+                if (m_pos == m_end)
+                    return false;
+
+                switch (*m_pos++)
+                {
+                case '"': out.push_back('"'); break;
+                case '\\': out.push_back('\\'); break;
+                case '/': out.push_back('/'); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u':
+                {
+                    unsigned int code = 0;
+                    if (!parseHex(code))
+                        return false;
+                    if (code >= 0xD800 && code < 0xDC00)
+                    {
+                        unsigned int low = 0;
+                        if (!match("\\u") || !parseHex(low) || low < 0xDC00 || low >= 0xE000)
+                            return false;
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+            if (m_pos == m_end)
+                return false;
+            ++m_pos;
+            return true;
+        }
+
+        bool parseHex(unsigned int& code)
+        {
+            if (m_end - m_pos < 4)
+                return false;
+            std::from_chars_result result = std::from_chars(m_pos, m_pos + 4, code, 16);
+            if (result.ec != std::errc() || result.ptr != m_pos + 4)
+                return false;
+            m_pos += 4;
+            return true;
+        }
+
+        static void appendUtf8(std::string& out, unsigned int code)
+        {
+            if (code < 0x80)
+            {
+                out.push_back(char(code));
+            }
+            else if (code < 0x800)
+            {
+                out.push_back(char(0xC0 | (code >> 6)));
+                out.push_back(char(0x80 | (code & 0x3F)));
+            }
+            else if (code < 0x10000)
+            {
+                out.push_back(char(0xE0 | (code >> 12)));
+                out.push_back(char(0x80 | ((code >> 6) & 0x3F)));
+                out.push_back(char(0x80 | (code & 0x3F)));
+            }
+            else
+            {
+                out.push_back(char(0xF0 | (code >> 18)));
+                out.push_back(char(0x80 | ((code >> 12) & 0x3F)));
+                out.push_back(char(0x80 | ((code >> 6) & 0x3F)));
+                out.push_back(char(0x80 | (code & 0x3F)));
+            }
+        }
+    };
+
+    // ---  GLB ---
+
+    const uint32_t GLB_MAGIC = 0x46546C67; // "glTF"
+    const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+    const uint32_t GLB_CHUNK_BIN = 0x004E4942;
+
+    //  glTF (  GL)
+    const int COMPONENT_UNSIGNED_BYTE = 5121;
+    const int COMPONENT_UNSIGNED_SHORT = 5123;
+    const int COMPONENT_UNSIGNED_INT = 5125;
+    const int COMPONENT_FLOAT = 5126;
+    const int MODE_TRIANGLES = 4;
+
+    uint32_t readU32(const unsigned char* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value; // GLB  little-endian,     
+    }
+
+    // ,     
+    struct AccessorView {
+        const unsigned char* data = nullptr; //  
+        size_t count = 0;
+        size_t stride = 0;
+        int componentType = 0;
+    };
+
+    size_t componentSize(int componentType)
+    {
+        switch (componentType)
+        {
+        case COMPONENT_UNSIGNED_BYTE: return 1;
+        case COMPONENT_UNSIGNED_SHORT: return 2;
+        case COMPONENT_UNSIGNED_INT:
+        case COMPONENT_FLOAT: return 4;
+        default: return 0;
+        }
+    }
+
+    size_t componentCount(const std::string& type)
+    {
+        if (type == "SCALAR") return 1;
+        if (type == "VEC2") return 2;
+        if (type == "VEC3") return 3;
+        if (type == "VEC4") return 4;
+        return 0;
+    }
+
+    class GlbDocument
+    {
+    public:
+        JsonValue json;
+        const unsigned char* bin = nullptr;
+        size_t binSize = 0;
+        std::string error;
+        std::unordered_map<long long, uint32_t> meshStart; //  glTF ->   MeshData,   
+
+        bool fail(const std::string& reason)
+        {
+            error = reason;
+            return false;
+        }
+
+        //    ; expectedComponent = 0    
+        bool accessor(long long index, const char* expectedType, int expectedComponent, AccessorView& view)
+        {
+            const JsonValue* accessors = json.find("accessors");
+            const JsonValue* accessor = accessors ? accessors->at(size_t(index)) : nullptr;
+            if (index < 0 || !accessor)
+                return fail("missing accessor");
+            if (accessor->find("sparse"))
+                return fail("sparse accessor");
+
+            const JsonValue* type = accessor->find("type");
+            if (!type || type->string != expectedType)
+                return fail(std::string("accessor type is not ") + expectedType);
+
+            view.componentType = int(accessor->numberOr("componentType", 0));
+            if (expectedComponent ? view.componentType != expectedComponent
+                : (view.componentType == COMPONENT_FLOAT || componentSize(view.componentType) == 0))
+                return fail("unsupported accessor component type");
+
+            long long count = accessor->index("count");
+            long long viewIndex = accessor->index("bufferView");
+            const JsonValue* views = json.find("bufferViews");
+            const JsonValue* bufferView = views && viewIndex >= 0 ? views->at(size_t(viewIndex)) : nullptr;
+            if (count < 0 || !bufferView)
+                return fail("accessor without buffer view");
+            if ((unsigned long long)count > binSize)
+                return fail("accessor out of bounds");
+            if (bufferView->index("buffer") != 0)
+                return fail("external buffer");
+
+            const size_t elementSize = componentSize(view.componentType) * componentCount(expectedType);
+            const long long viewOffset = bufferView->index("byteOffset") < 0 ? 0 : bufferView->index("byteOffset");
+            const long long viewLength = bufferView->index("byteLength");
+            const long long accessorOffset = accessor->index("byteOffset") < 0 ? 0 : accessor->index("byteOffset");
+            const long long stride = bufferView->index("byteStride") < 0 ? (long long)elementSize : bufferView->index("byteStride");
+            if (viewLength < 0 || stride < (long long)elementSize)
+                return fail("bad buffer view");
+
+            //        bufferView,    
+            const unsigned long long needed = count == 0 ? 0 : accessorOffset + (count - 1) * stride + elementSize;
+            if (needed > (unsigned long long)viewLength || (unsigned long long)(viewOffset + viewLength) > binSize)
+                return fail("accessor out of bounds");
+
+            view.data = bin + viewOffset + accessorOffset;
+            view.count = size_t(count);
+            view.stride = size_t(stride);
+            return true;
+        }
+    };
+
+    bool openGlb(const MappedFile& file, GlbDocument& document)
+    {
+        const unsigned char* data = file.data();
+        const size_t size = file.size();
+        if (size < 20 || readU32(data) != GLB_MAGIC || readU32(data + 4) != 2)
+            return document.fail("not a glTF 2.0 binary");
+        if (readU32(data + 8) > size)
+            return document.fail("truncated file");
+
+        //  0  JSON,  1 ()  BIN
+        size_t offset = 12;
+        const uint32_t jsonLength = readU32(data + offset);
+        if (readU32(data + offset + 4) != GLB_CHUNK_JSON || jsonLength > size - offset - 8)
+            return document.fail("bad JSON chunk");
+
+        JsonParser parser(reinterpret_cast<const char*>(data + offset + 8),
+            reinterpret_cast<const char*>(data + offset + 8 + jsonLength));
+        if (!parser.parse(document.json) || document.json.type != JsonValue::Object)
+            return document.fail("invalid JSON");
+
+        offset += 8 + ((size_t(jsonLength) + 3) & ~size_t(3));
+        if (offset + 8 <= size && readU32(data + offset + 4) == GLB_CHUNK_BIN)
+        {
+            const uint32_t binLength = readU32(data + offset);
+            if (binLength > size - offset - 8)
+                return document.fail("bad BIN chunk");
+            document.bin = data + offset + 8;
+            document.binSize = binLength;
+        }
+        return true;
+    }
+
+    //  :    base color ( AI_MATKEY_COLOR_DIFFUSE  aiTextureType_DIFFUSE  Assimp)
+    bool readMaterial(GlbDocument& document, long long index, MeshData& data)
+    {
+        const JsonValue* materials = document.json.find("materials");
+        const JsonValue* material = materials && index >= 0 ? materials->at(size_t(index)) : nullptr;
+        if (!material)
+            return document.fail("primitive without material"); // Assimp    
+        if (material->find("normalTexture"))
+            return document.fail("normal map needs tangents");
+
+        const JsonValue* pbr = material->find("pbrMetallicRoughness");
+        const JsonValue* factor = pbr ? pbr->find("baseColorFactor") : nullptr;
+        if (factor && factor->items.size() >= 3)
+            data.color = glm::vec3(float(factor->items[0].number), float(factor->items[1].number), float(factor->items[2].number));
+
+        const JsonValue* baseTexture = pbr ? pbr->find("baseColorTexture") : nullptr;
+        if (baseTexture)
+        {
+            const JsonValue* textures = document.json.find("textures");
+            const long long textureIndex = baseTexture->index("index");
+            const JsonValue* texture = textures && textureIndex >= 0 ? textures->at(size_t(textureIndex)) : nullptr;
+            const JsonValue* images = document.json.find("images");
+            const long long imageIndex = texture ? texture->index("source") : -1;
+            const JsonValue* image = images && imageIndex >= 0 ? images->at(size_t(imageIndex)) : nullptr;
+            const JsonValue* uri = image ? image->find("uri") : nullptr;
+            if (!uri || uri->type != JsonValue::String || uri->string.compare(0, 5, "data:") == 0)
+                return document.fail("embedded image");
+            data.textures.push_back({ "texture_diffuse", uri->string });
+        }
+        return true;
+    }
+
+    //  -> MeshData:         ,
+    //      
+    template <class V>
+    void readVertices(const AccessorView& positions, const AccessorView* normals, const AccessorView* texCoords, V* out,
+        MeshData& data)
+    {
+        copyPositions(positions.data, positions.count, positions.stride,
+            reinterpret_cast<unsigned char*>(out) + offsetof(V, Position), sizeof(V), data.boundsMin, data.boundsMax);
+        for (size_t i = 0; i < positions.count; ++i)
+        {
+            if (normals)
+                std::memcpy(&out[i].Normal, normals->data + i * normals->stride, sizeof(glm::vec3));
+            if constexpr (VertexTraits<V>::texCoords)
+            {
+                if (texCoords)
+                    std::memcpy(&out[i].TexCoords, texCoords->data + i * texCoords->stride, sizeof(glm::vec2));
+            }
+        }
+    }
+
+    bool readPrimitive(GlbDocument& document, const JsonValue& primitive, MeshData& data)
+    {
+        if (primitive.numberOr("mode", MODE_TRIANGLES) != MODE_TRIANGLES)
+            return document.fail("primitive is not a triangle list");
+        if (primitive.find("targets"))
+            return document.fail("morph targets");
+
+        const JsonValue* attributes = primitive.find("attributes");
+        if (!attributes || attributes->find("JOINTS_0"))
+            return document.fail(attributes ? "skinned primitive" : "primitive without attributes");
+
+        AccessorView positions, normals, texCoords;
+        if (!document.accessor(attributes->index("POSITION"), "VEC3", COMPONENT_FLOAT, positions))
+            return false;
+        const bool hasNormals = attributes->find("NORMAL") != nullptr;
+        if (hasNormals && !document.accessor(attributes->index("NORMAL"), "VEC3", COMPONENT_FLOAT, normals))
+            return false;
+        const bool hasTexCoords = attributes->find("TEXCOORD_0") != nullptr;
+        if (hasTexCoords && !document.accessor(attributes->index("TEXCOORD_0"), "VEC2", COMPONENT_FLOAT, texCoords))
+            return false;
+        if ((hasNormals && normals.count != positions.count) || (hasTexCoords && texCoords.count != positions.count))
+            return document.fail("attribute counts differ");
+
+        if (!readMaterial(document, primitive.index("material"), data))
+            return false;
+
+        //    chooseVertexFormat  aiMesh:  UV   ,  Static
+        data.format = hasTexCoords ? VertexFormat::Static : VertexFormat::PositionNormal;
+        data.vertices.assign(positions.count * vertexSize(data.format), 0);
+        withVertexType(data.format, [&](auto* tag)
+        {
+            typedef typename std::remove_pointer<decltype(tag)>::type V;
+            if constexpr (!VertexTraits<V>::quantized)
+                readVertices<V>(positions, hasNormals ? &normals : nullptr, hasTexCoords ? &texCoords : nullptr,
+                    data.vertexArray<V>(), data);
+        });
+
+        //      ,     
+        if (positions.count > 0)
+        {
+            data.sphereCenter = (data.boundsMin + data.boundsMax) * 0.5f;
+            data.sphereRadius = boundingRadius(positions.data, positions.count, positions.stride, data.sphereCenter);
+        }
+
+        // :     
+        if (primitive.find("indices"))
+        {
+            AccessorView indices;
+            if (!document.accessor(primitive.index("indices"), "SCALAR", 0, indices))
+                return false;
+
+            data.indices.resize(indices.count);
+            for (size_t i = 0; i < indices.count; ++i)
+            {
+                const unsigned char* p = indices.data + i * indices.stride;
+                uint32_t index = 0;
+                if (indices.componentType == COMPONENT_UNSIGNED_BYTE)
+                    index = *p;
+                else if (indices.componentType == COMPONENT_UNSIGNED_SHORT)
+                    index = uint16_t(p[0] | (p[1] << 8));
+                else
+                    index = readU32(p);
+                if (index >= positions.count)
+                    return document.fail("index out of range");
+                data.indices[i] = index;
+            }
+        }
+        else
+        {
+            data.indices.resize(positions.count);
+            for (size_t i = 0; i < positions.count; ++i)
+                data.indices[i] = static_cast<unsigned int>(i);
+        }
+
+        //   Triangulate  Assimp  
+        data.indices.resize(data.indices.size() / 3 * 3);
+        return true;
+    }
+
+    //   count ; false   ,     
+    bool readNumbers(const JsonValue& node, const char* key, float* out, size_t count)
+    {
+        const JsonValue* value = node.find(key);
+        if (!value)
+            return true;
+        if (value->type != JsonValue::Array || value->items.size() != count)
+            return false;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (value->items[i].type != JsonValue::Number)
+                return false;
+            out[i] = static_cast<float>(value->items[i].number);
+        }
+        return true;
+    }
+
+    //   : matrix ( ,  glm)  T * R * S
+    bool readNodeTransform(const JsonValue& node, glm::mat4& local)
+    {
+        float matrix[16];
+        if (node.find("matrix"))
+        {
+            if (!readNumbers(node, "matrix", matrix, 16))
+                return false;
+            local = glm::make_mat4(matrix);
+            return true;
+        }
+
+        float translation[3] = { 0.0f, 0.0f, 0.0f };
+        float rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f }; // x, y, z, w
+        float scale[3] = { 1.0f, 1.0f, 1.0f };
+        if (!readNumbers(node, "translation", translation, 3) || !readNumbers(node, "rotation", rotation, 4) ||
+            !readNumbers(node, "scale", scale, 3))
+            return false;
+
+        local = glm::translate(glm::mat4(1.0f), glm::make_vec3(translation))
+            * glm::mat4_cast(glm::quat(rotation[3], rotation[0], rotation[1], rotation[2]))
+            * glm::scale(glm::mat4(1.0f), glm::make_vec3(scale));
+        return true;
+    }
+
+    //    :      ,   Model   Assimp.
+    //    graph      ,  SceneGraph  
+    bool collectNode(GlbDocument& document, long long nodeIndex, uint32_t parent, std::vector<MeshData>& meshes,
+        std::vector<MeshInstance>& instances, SceneGraph& graph, int depth)
+    {
+        const JsonValue* nodes = document.json.find("nodes");
+        const JsonValue* node = nodes && nodeIndex >= 0 ? nodes->at(size_t(nodeIndex)) : nullptr;
+        if (!node || depth > 64)
+            return document.fail("bad node hierarchy");
+        if (node->find("skin"))
+            return document.fail("skinned node");
+
+        glm::mat4 local(1.0f);
+        if (!readNodeTransform(*node, local))
+            return document.fail("bad node transform");
+        const uint32_t sceneNode = graph.addNode(parent, local);
+
+        if (node->find("mesh"))
+        {
+            const JsonValue* gltfMeshes = document.json.find("meshes");
+            const long long meshIndex = node->index("mesh");
+            const JsonValue* mesh = gltfMeshes && meshIndex >= 0 ? gltfMeshes->at(size_t(meshIndex)) : nullptr;
+            const JsonValue* primitives = mesh ? mesh->find("primitives") : nullptr;
+            if (!primitives || primitives->type != JsonValue::Array)
+                return document.fail("mesh without primitives");
+
+            //       ,     
+            auto start = document.meshStart.find(meshIndex);
+            if (start == document.meshStart.end())
+            {
+                start = document.meshStart.emplace(meshIndex, static_cast<uint32_t>(meshes.size())).first;
+                for (const JsonValue& primitive : primitives->items)
+                {
+                    meshes.emplace_back();
+                    if (!readPrimitive(document, primitive, meshes.back()))
+                        return false;
+                }
+            }
+            for (size_t p = 0; p < primitives->items.size(); ++p)
+                instances.push_back({ start->second + static_cast<uint32_t>(p), sceneNode });
+        }
+
+        if (const JsonValue* children = node->find("children"))
+        {
+            for (const JsonValue& child : children->items)
+            {
+                if (child.type != JsonValue::Number)
+                    return document.fail("bad node hierarchy");
+                if (!collectNode(document, (long long)child.number, sceneNode, meshes, instances, graph, depth + 1))
+                    return false;
+            }
+        }
+        return true;
+    }
+}
+
+bool isGlbPath(const std::string& path)
+{
+    if (path.size() < 4)
+        return false;
+    std::string extension = path.substr(path.size() - 4);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".glb";
+}
+
+bool loadGlb(const std::string& path, std::vector<MeshData>& meshes, std::vector<MeshInstance>& instances,
+    std::string& reason, SceneGraph& graph)
+{
+    meshes.clear();
+    instances.clear();
+    graph.clear();
+
+    MappedFile file;
+    if (!file.open(path))
+    {
+        reason = "cannot open file";
+        return false;
+    }
+
+    GlbDocument document;
+    if (!openGlb(file, document))
+    {
+        reason = document.error;
+        return false;
+    }
+
+    if (document.json.find("extensionsUsed") || document.json.find("extensionsRequired"))
+    {
+        reason = "glTF extensions";
+        return false;
+    }
+
+    const JsonValue* buffers = document.json.find("buffers");
+    if (buffers && (buffers->items.size() > 1 || (buffers->at(0) && buffers->at(0)->find("uri"))))
+    {
+        reason = "external buffer";
+        return false;
+    }
+
+    //   ;    
+    const JsonValue* scenes = document.json.find("scenes");
+    const long long sceneIndex = document.json.index("scene") < 0 ? 0 : document.json.index("scene");
+    const JsonValue* scene = scenes ? scenes->at(size_t(sceneIndex)) : nullptr;
+    const JsonValue* roots = scene ? scene->find("nodes") : nullptr;
+    if (!roots)
+    {
+        reason = "no scene";
+        return false;
+    }
+
+    //   glTF         
+    const uint32_t root = graph.addNode(SceneGraph::NO_PARENT, glm::mat4(1.0f));
+    for (const JsonValue& node : roots->items)
+    {
+        if (node.type != JsonValue::Number || !collectNode(document, (long long)node.number, root, meshes, instances, graph, 0))
+        {
+            reason = document.error.empty() ? "bad scene" : document.error;
+            meshes.clear();
+            instances.clear();
+            graph.clear();
+            return false;
+        }
+    }
+    return true;
+}
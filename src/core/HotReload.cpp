@@ -0,0 +1,103 @@
+#include "HotReload.h"
+#include "TextureRegistry.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+void HotReload::update(Model* current, const std::string& path, ModelLoader& loader, const ImportOptions& options)
+{
+    // - ,    
+    if (m_uploader)
+        m_uploader->generateMipmaps();
+
+    if (loader.isBusy())
+        return;
+
+    //    (   ):   
+    if (current != m_watched)
+    {
+        m_watcher.clear();
+        if (current)
+        {
+            for (const std::string& file : current->getSourceFiles())
+                m_watcher.watch(file);
+        }
+        m_watched = current;
+        m_stats.watchedFiles = m_watcher.getFileCount();
+    }
+
+    const std::vector<std::string> changed = m_watcher.poll();
+    if (changed.empty())
+        return;
+
+    //   ,    ;       
+    TextureRegistry& registry = TextureRegistry::instance();
+    std::vector<std::string> textures;
+    std::string modelFile;
+    for (const std::string& file : changed)
+    {
+        if (registry.find(file) != 0)
+            textures.push_back(file);
+        else if (modelFile.empty())
+            modelFile = file;
+    }
+
+    //  :        
+    if (!textures.empty())
+        reloadTextures(current, textures);
+
+    if (!modelFile.empty())
+    {
+        std::cout << "Hot reload: " << modelFile << " changed, reloading " << path << std::endl;
+        loader.start(path, options, true);
+        ++m_stats.modelReloads;
+    }
+}
+
+void HotReload::shutdown()
+{
+    m_watcher.clear();
+    m_watched = nullptr;
+    m_uploader.reset();
+}
+
+void HotReload::reloadTextures(Model* model, const std::vector<std::string>& keys)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    //   ,   GPU  ,   GL
+    std::vector<DecodedTexture> images(keys.size());
+    {
+        ThreadPool pool(static_cast<unsigned int>(std::min<size_t>(keys.size(), ThreadPool::hardwareThreads())));
+        pool.parallelFor(keys.size(), [&](size_t i)
+        {
+            images[i] = decodeTexture(keys[i], true);
+        });
+    }
+
+    if (!m_uploader)
+        m_uploader.reset(new TextureUploader());
+
+    TextureRegistry& registry = TextureRegistry::instance();
+    unsigned int reloaded = 0;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        //          
+        if (!images[i].valid())
+            continue;
+        const unsigned int id = model ? model->detachTexture(keys[i]) : registry.find(keys[i]);
+        if (id == 0)
+            continue;
+        m_uploader->upload(id, images[i]);
+        registry.setContentHash(id, images[i].contentHash);
+        ++reloaded;
+    }
+
+    m_stats.lastTextures = reloaded;
+    m_stats.lastTextureMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    ++m_stats.textureReloads;
+    std::cout << "Hot reload: " << reloaded << " of " << keys.size() << " texture(s) re-decoded in "
+        << m_stats.lastTextureMs << " ms" << std::endl;
+}
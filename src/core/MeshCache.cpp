@@ -0,0 +1,366 @@
+#include "MeshCache.h"
+#include "Hash.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    const char MESH_CACHE_MAGIC[4] = { 'M', 'S', 'H', 'C' };
+
+    //  ,         
+    uint64_t alignUp(uint64_t value)
+    {
+        return (value + 15) & ~uint64_t(15);
+    }
+
+    void writePadding(std::ofstream& out, uint64_t from, uint64_t to)
+    {
+        static const char zeros[16] = {};
+        if (to > from)
+            out.write(zeros, static_cast<std::streamsize>(to - from));
+    }
+
+    // ,   [offset, offset + size)   
+    bool inRange(uint64_t offset, uint64_t size, uint64_t fileSize)
+    {
+        return offset <= fileSize && size <= fileSize - offset;
+    }
+}
+
+std::string MeshCache::cachePathFor(const std::string& sourcePath)
+{
+    return sourcePath + ".meshcache";
+}
+
+uint64_t MeshCache::hashFile(const std::string& path, bool& ok)
+{
+    MappedFile file;
+    ok = file.open(path);
+    if (!ok)
+        return 0;
+
+    return fnv1a(file.data(), file.size());
+}
+
+bool MeshCache::write(const std::string& cachePath, uint64_t sourceHash, uint32_t settings,
+    uint32_t conversion, const std::vector<MeshData>& meshes, const std::vector<MeshInstance>& instances,
+    const SceneGraph& graph)
+{
+    // 1.    
+    std::vector<MeshCacheTexture> textures;
+    std::string strings;
+    std::vector<Meshlet> meshlets;
+
+    std::vector<MeshCacheEntry> entries(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const MeshData& mesh = meshes[i];
+        MeshCacheEntry& entry = entries[i];
+
+        entry.firstTexture = static_cast<uint32_t>(textures.size());
+        entry.textureCount = static_cast<uint32_t>(mesh.textures.size());
+        for (const TextureRef& texture : mesh.textures)
+        {
+            MeshCacheTexture ref;
+            ref.typeOffset = static_cast<uint32_t>(strings.size());
+            ref.typeLength = static_cast<uint32_t>(texture.type.size());
+            strings += texture.type;
+            ref.pathOffset = static_cast<uint32_t>(strings.size());
+            ref.pathLength = static_cast<uint32_t>(texture.path.size());
+            strings += texture.path;
+            textures.push_back(ref);
+        }
+
+        std::memcpy(entry.color, &mesh.color[0], sizeof(entry.color));
+        std::memcpy(entry.boundsMin, &mesh.boundsMin[0], sizeof(entry.boundsMin));
+        std::memcpy(entry.boundsMax, &mesh.boundsMax[0], sizeof(entry.boundsMax));
+        std::memcpy(entry.sphereCenter, &mesh.sphereCenter[0], sizeof(entry.sphereCenter));
+        entry.sphereRadius = mesh.sphereRadius;
+        entry.acmrBefore = mesh.cacheBefore.acmr;
+        entry.atvrBefore = mesh.cacheBefore.atvr;
+        entry.acmrAfter = mesh.cacheAfter.acmr;
+        entry.atvrAfter = mesh.cacheAfter.atvr;
+        entry.overdrawBefore = mesh.overdrawBefore;
+        entry.overdrawAfter = mesh.overdrawAfter;
+        entry.verticesBeforeWeld = static_cast<uint32_t>(mesh.verticesBeforeWeld);
+        entry.contentHash = mesh.contentHash;
+        entry.lodCount = static_cast<uint32_t>(std::min<size_t>(mesh.lods.size(), MAX_MESH_LODS));
+        std::copy(mesh.lods.begin(), mesh.lods.begin() + entry.lodCount, entry.lods);
+        entry.firstMeshlet = static_cast<uint32_t>(meshlets.size());
+        entry.meshletCount = static_cast<uint32_t>(mesh.meshlets.size());
+        meshlets.insert(meshlets.end(), mesh.meshlets.begin(), mesh.meshlets.end());
+
+        entry.vertexFormat = static_cast<uint32_t>(mesh.format);
+        entry.vertexCount = static_cast<uint32_t>(mesh.vertexCount());
+        entry.indexCount = static_cast<uint32_t>(mesh.indexCount());
+        entry.indexSize = mesh.indexSize();
+    }
+
+    std::vector<MeshCacheNode> nodes(graph.getNodeCount());
+    for (uint32_t i = 0; i < nodes.size(); ++i)
+    {
+        nodes[i].parent = graph.getParent(i);
+        std::memcpy(nodes[i].local, &graph.getLocal(i)[0][0], sizeof(nodes[i].local));
+    }
+
+    // 2.  
+    MeshCacheHeader header = {};
+    std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+    header.version = MESH_CACHE_VERSION;
+    header.vertexSize = sizeof(Vertex);
+    header.settings = settings;
+    header.conversion = conversion;
+    header.sourceHash = sourceHash;
+    header.meshCount = static_cast<uint32_t>(meshes.size());
+    header.textureCount = static_cast<uint32_t>(textures.size());
+    header.entriesOffset = alignUp(sizeof(MeshCacheHeader));
+    header.texturesOffset = alignUp(header.entriesOffset + entries.size() * sizeof(MeshCacheEntry));
+    header.stringsOffset = alignUp(header.texturesOffset + textures.size() * sizeof(MeshCacheTexture));
+    header.stringsSize = strings.size();
+    header.meshletCount = static_cast<uint32_t>(meshlets.size());
+    header.meshletsOffset = alignUp(header.stringsOffset + header.stringsSize);
+    header.nodeCount = static_cast<uint32_t>(nodes.size());
+    header.nodesOffset = alignUp(header.meshletsOffset + meshlets.size() * sizeof(Meshlet));
+    header.instanceCount = static_cast<uint32_t>(instances.size());
+    header.instancesOffset = alignUp(header.nodesOffset + nodes.size() * sizeof(MeshCacheNode));
+
+    uint64_t offset = alignUp(header.instancesOffset + instances.size() * sizeof(MeshInstance));
+    for (MeshCacheEntry& entry : entries)
+    {
+        entry.vertexOffset = offset;
+        offset = alignUp(offset + uint64_t(entry.vertexCount) * vertexSize(VertexFormat(entry.vertexFormat)));
+        entry.indexOffset = offset;
+        offset = alignUp(offset + uint64_t(entry.indexCount) * entry.indexSize);
+    }
+    header.fileSize = offset;
+
+    // 3.    ,  ,
+    //       
+    std::string tmpPath = cachePath + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "ERROR::MESH_CACHE::Cannot write " << tmpPath << std::endl;
+        return false;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writePadding(out, sizeof(header), header.entriesOffset);
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(MeshCacheEntry));
+    writePadding(out, header.entriesOffset + entries.size() * sizeof(MeshCacheEntry), header.texturesOffset);
+    out.write(reinterpret_cast<const char*>(textures.data()), textures.size() * sizeof(MeshCacheTexture));
+    writePadding(out, header.texturesOffset + textures.size() * sizeof(MeshCacheTexture), header.stringsOffset);
+    out.write(strings.data(), strings.size());
+    writePadding(out, header.stringsOffset + strings.size(), header.meshletsOffset);
+    out.write(reinterpret_cast<const char*>(meshlets.data()), meshlets.size() * sizeof(Meshlet));
+    writePadding(out, header.meshletsOffset + meshlets.size() * sizeof(Meshlet), header.nodesOffset);
+    out.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(MeshCacheNode));
+    writePadding(out, header.nodesOffset + nodes.size() * sizeof(MeshCacheNode), header.instancesOffset);
+    out.write(reinterpret_cast<const char*>(instances.data()), instances.size() * sizeof(MeshInstance));
+
+    uint64_t written = header.instancesOffset + instances.size() * sizeof(MeshInstance);
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const MeshData& mesh = meshes[i];
+        const MeshCacheEntry& entry = entries[i];
+
+        const size_t vertexBytes = size_t(entry.vertexCount) * vertexSize(mesh.format);
+        writePadding(out, written, entry.vertexOffset);
+        out.write(reinterpret_cast<const char*>(mesh.vertices.data()), vertexBytes);
+        written = entry.vertexOffset + vertexBytes;
+
+        writePadding(out, written, entry.indexOffset);
+        const size_t indexBytes = size_t(entry.indexCount) * entry.indexSize;
+        out.write(static_cast<const char*>(mesh.indexData()), indexBytes);
+        written = entry.indexOffset + indexBytes;
+    }
+    writePadding(out, written, header.fileSize);
+
+    out.close();
+    if (!out)
+    {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    std::remove(cachePath.c_str());
+    if (std::rename(tmpPath.c_str(), cachePath.c_str()) != 0)
+    {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool MeshCache::open(const std::string& cachePath, uint64_t sourceHash, uint32_t settings, uint32_t conversion)
+{
+    m_header = nullptr;
+    if (!m_file.open(cachePath))
+        return false;
+
+    const uint64_t fileSize = m_file.size();
+    if (fileSize < sizeof(MeshCacheHeader))
+        return false;
+
+    const MeshCacheHeader* header = reinterpret_cast<const MeshCacheHeader*>(m_file.data());
+    if (std::memcmp(header->magic, MESH_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != MESH_CACHE_VERSION ||
+        header->vertexSize != sizeof(Vertex) ||
+        header->settings != settings ||
+        header->conversion != conversion ||
+        header->sourceHash != sourceHash ||
+        header->fileSize != fileSize)
+    {
+        m_file.close(); //       
+        return false;
+    }
+
+    //     ,          
+    if (!inRange(header->entriesOffset, uint64_t(header->meshCount) * sizeof(MeshCacheEntry), fileSize) ||
+        !inRange(header->texturesOffset, uint64_t(header->textureCount) * sizeof(MeshCacheTexture), fileSize) ||
+        !inRange(header->stringsOffset, header->stringsSize, fileSize) ||
+        !inRange(header->meshletsOffset, uint64_t(header->meshletCount) * sizeof(Meshlet), fileSize) ||
+        !inRange(header->nodesOffset, uint64_t(header->nodeCount) * sizeof(MeshCacheNode), fileSize) ||
+        !inRange(header->instancesOffset, uint64_t(header->instanceCount) * sizeof(MeshInstance), fileSize))
+    {
+        m_file.close();
+        return false;
+    }
+
+    const MeshCacheEntry* entries = reinterpret_cast<const MeshCacheEntry*>(m_file.data() + header->entriesOffset);
+    const MeshCacheTexture* textures = reinterpret_cast<const MeshCacheTexture*>(m_file.data() + header->texturesOffset);
+    const Meshlet* meshlets = reinterpret_cast<const Meshlet*>(m_file.data() + header->meshletsOffset);
+    const MeshCacheNode* nodes = reinterpret_cast<const MeshCacheNode*>(m_file.data() + header->nodesOffset);
+    const MeshInstance* instances = reinterpret_cast<const MeshInstance*>(m_file.data() + header->instancesOffset);
+
+    //      SceneGraph     
+    for (uint32_t i = 0; i < header->nodeCount; ++i)
+    {
+        if (nodes[i].parent != SceneGraph::NO_PARENT && nodes[i].parent >= i)
+        {
+            m_file.close();
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < header->instanceCount; ++i)
+    {
+        if (instances[i].mesh >= header->meshCount || instances[i].node >= header->nodeCount)
+        {
+            m_file.close();
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < header->meshCount; ++i)
+    {
+        const MeshCacheEntry& entry = entries[i];
+        const size_t stride = vertexSize(VertexFormat(entry.vertexFormat));
+        if (stride == 0 || (entry.indexSize != 2 && entry.indexSize != 4) ||
+            !inRange(entry.vertexOffset, uint64_t(entry.vertexCount) * stride, fileSize) ||
+            !inRange(entry.indexOffset, uint64_t(entry.indexCount) * entry.indexSize, fileSize) ||
+            uint64_t(entry.firstTexture) + entry.textureCount > header->textureCount ||
+            entry.lodCount > MAX_MESH_LODS ||
+            uint64_t(entry.firstMeshlet) + entry.meshletCount > header->meshletCount)
+        {
+            m_file.close();
+            return false;
+        }
+
+        for (uint32_t lod = 0; lod < entry.lodCount; ++lod)
+        {
+            if (!inRange(entry.lods[lod].firstIndex, entry.lods[lod].indexCount, entry.indexCount))
+            {
+                m_file.close();
+                return false;
+            }
+        }
+
+        for (uint32_t m = 0; m < entry.meshletCount; ++m)
+        {
+            const Meshlet& meshlet = meshlets[entry.firstMeshlet + m];
+            if (!inRange(meshlet.firstIndex, meshlet.indexCount, entry.indexCount))
+            {
+                m_file.close();
+                return false;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < header->textureCount; ++i)
+    {
+        const MeshCacheTexture& ref = textures[i];
+        if (!inRange(ref.typeOffset, ref.typeLength, header->stringsSize) ||
+            !inRange(ref.pathOffset, ref.pathLength, header->stringsSize))
+        {
+            m_file.close();
+            return false;
+        }
+    }
+
+    m_header = header;
+    m_entries = entries;
+    m_textures = textures;
+    m_meshlets = meshlets;
+    m_nodes = nodes;
+    m_instances = instances;
+    m_strings = reinterpret_cast<const char*>(m_file.data() + header->stringsOffset);
+    return true;
+}
+
+size_t MeshCache::getMeshCount() const
+{
+    return m_header ? m_header->meshCount : 0;
+}
+
+size_t MeshCache::getNodeCount() const
+{
+    return m_header ? m_header->nodeCount : 0;
+}
+
+const MeshCacheNode& MeshCache::getNode(size_t node) const
+{
+    return m_nodes[node];
+}
+
+size_t MeshCache::getInstanceCount() const
+{
+    return m_header ? m_header->instanceCount : 0;
+}
+
+const MeshCacheEntry& MeshCache::getEntry(size_t mesh) const
+{
+    return m_entries[mesh];
+}
+
+const void* MeshCache::getVertices(size_t mesh) const
+{
+    return m_file.data() + m_entries[mesh].vertexOffset;
+}
+
+const void* MeshCache::getIndices(size_t mesh) const
+{
+    return m_file.data() + m_entries[mesh].indexOffset;
+}
+
+const Meshlet* MeshCache::getMeshlets(size_t mesh) const
+{
+    return m_meshlets + m_entries[mesh].firstMeshlet;
+}
+
+std::string MeshCache::getTextureType(size_t mesh, size_t texture) const
+{
+    const MeshCacheTexture& ref = m_textures[m_entries[mesh].firstTexture + texture];
+    return std::string(m_strings + ref.typeOffset, ref.typeLength);
+}
+
+std::string MeshCache::getTexturePath(size_t mesh, size_t texture) const
+{
+    const MeshCacheTexture& ref = m_textures[m_entries[mesh].firstTexture + texture];
+    return std::string(m_strings + ref.pathOffset, ref.pathLength);
+}
@@ -0,0 +1,660 @@
+#include "MeshOptimizer.h"
+#include "Hash.h"
+#include "ScratchArena.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+VertexCacheStats analyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+    unsigned int cacheSize)
+{
+    VertexCacheStats stats;
+    if (indexCount < 3 || vertexCount == 0)
+        return stats;
+
+    // timestamps[v]  ,   v   ; FIFO:  ,    
+    ScratchVector<size_t> timestamps(vertexCount, 0, scratchResource());
+    size_t time = cacheSize + 1;
+    size_t misses = 0;
+
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        unsigned int v = indices[i];
+        if (time - timestamps[v] > cacheSize)
+        {
+            timestamps[v] = time++;
+            ++misses;
+        }
+    }
+
+    stats.acmr = float(misses) / float(indexCount / 3);
+    stats.atvr = float(misses) / float(vertexCount);
+    return stats;
+}
+
+namespace
+{
+    //     "Linear-Speed Vertex Cache Optimisation"
+    const int FORSYTH_CACHE_SIZE = 32;
+    const float CACHE_DECAY_POWER = 1.5f;
+    const float LAST_TRIANGLE_SCORE = 0.75f;
+    const float VALENCE_BOOST_SCALE = 2.0f;
+    const float VALENCE_BOOST_POWER = 0.5f;
+
+    float vertexScore(int cachePosition, unsigned int remainingTriangles)
+    {
+        if (remainingTriangles == 0)
+            return -1.0f; //    
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            //        ,     
+            if (cachePosition < 3)
+                score = LAST_TRIANGLE_SCORE;
+            else
+                score = std::pow(1.0f - float(cachePosition - 3) / float(FORSYTH_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+        }
+
+        //         
+        score += VALENCE_BOOST_SCALE * std::pow(float(remainingTriangles), -VALENCE_BOOST_POWER);
+        return score;
+    }
+}
+
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0)
+        return;
+
+    // 1.    (     )
+    //      ,   
+    ScratchVector<unsigned int> remaining(vertexCount, 0, scratchResource());
+    for (unsigned int v : indices)
+        ++remaining[v];
+
+    ScratchVector<size_t> offsets(vertexCount + 1, 0, scratchResource());
+    for (size_t v = 0; v < vertexCount; ++v)
+        offsets[v + 1] = offsets[v] + remaining[v];
+
+    ScratchVector<unsigned int> adjacency(offsets[vertexCount], scratchResource());
+    ScratchVector<size_t> fill(offsets.begin(), offsets.end() - 1, scratchResource());
+    for (size_t t = 0; t < triangleCount; ++t)
+        for (int k = 0; k < 3; ++k)
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+
+    // 2.  
+    ScratchVector<int> cachePosition(vertexCount, -1, scratchResource());
+    ScratchVector<float> vertexScores(vertexCount, scratchResource());
+    for (size_t v = 0; v < vertexCount; ++v)
+        vertexScores[v] = vertexScore(-1, remaining[v]);
+
+    ScratchVector<char> emitted(triangleCount, 0, scratchResource());
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+
+    // LRU-:    ; +3   ,   
+    ScratchVector<unsigned int> cache(scratchResource());
+    ScratchVector<unsigned int> nextCache(scratchResource());
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    nextCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+    size_t best = SIZE_MAX;
+    size_t scanCursor = 0;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+    {
+        //         
+        if (best == SIZE_MAX)
+        {
+            while (emitted[scanCursor])
+                ++scanCursor;
+            best = scanCursor;
+        }
+
+        const unsigned int* tri = &indices[best * 3];
+        result.insert(result.end(), tri, tri + 3);
+        emitted[best] = 1;
+
+        //      
+        for (int k = 0; k < 3; ++k)
+        {
+            unsigned int v = tri[k];
+            unsigned int* begin = &adjacency[offsets[v]];
+            unsigned int* end = begin + remaining[v];
+            unsigned int* it = std::find(begin, end, static_cast<unsigned int>(best));
+            *it = *(end - 1);
+            --remaining[v];
+        }
+
+        //     ,  
+        nextCache.assign(tri, tri + 3);
+        for (unsigned int v : cache)
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                nextCache.push_back(v);
+        cache.swap(nextCache);
+
+        //         
+        for (size_t i = 0; i < cache.size(); ++i)
+        {
+            unsigned int v = cache[i];
+            cachePosition[v] = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+            vertexScores[v] = vertexScore(cachePosition[v], remaining[v]);
+        }
+
+        //          
+        float bestScore = -1.0f;
+        best = SIZE_MAX;
+        for (unsigned int v : cache)
+        {
+            for (size_t a = offsets[v]; a < offsets[v] + remaining[v]; ++a)
+            {
+                unsigned int t = adjacency[a];
+                const unsigned int* n = &indices[size_t(t) * 3];
+                float score = vertexScores[n[0]] + vertexScores[n[1]] + vertexScores[n[2]];
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = t;
+                }
+            }
+        }
+
+        if (cache.size() > FORSYTH_CACHE_SIZE)
+            cache.resize(FORSYTH_CACHE_SIZE);
+    }
+
+    indices.swap(result);
+}
+
+void optimizeVertexFetch(MeshData& data)
+{
+    const size_t vertexCount = data.vertexCount();
+    const size_t stride = vertexSize(data.format);
+    if (vertexCount == 0 || data.indices.empty())
+        return;
+
+    //       
+    ScratchVector<unsigned int> remap(vertexCount, ~0u, scratchResource());
+    unsigned int next = 0;
+    for (unsigned int& index : data.indices)
+    {
+        if (remap[index] == ~0u)
+            remap[index] = next++;
+        index = remap[index];
+    }
+
+    std::vector<unsigned char> vertices(size_t(next) * stride);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        if (remap[v] != ~0u)
+            std::memcpy(&vertices[size_t(remap[v]) * stride], &data.vertices[v * stride], stride);
+    }
+    data.vertices.swap(vertices);
+}
+
+void optimizeMesh(MeshData& data)
+{
+    data.cacheBefore = analyzeVertexCache(data.indices.data(), data.indices.size(), data.vertexCount());
+
+    optimizeVertexCache(data.indices, data.vertexCount());
+    optimizeVertexFetch(data);
+
+    data.cacheAfter = analyzeVertexCache(data.indices.data(), data.indices.size(), data.vertexCount());
+}
+
+namespace
+{
+    //      
+    const int OVERDRAW_VIEWPORT = 256;
+
+    // FIFO-     ; reset()    O(1)
+    class FifoCache
+    {
+    public:
+        explicit FifoCache(size_t vertexCount) : m_timestamps(vertexCount, 0, scratchResource()) {}
+
+        //     
+        unsigned int add(const unsigned int* triangle)
+        {
+            unsigned int misses = 0;
+            for (int k = 0; k < 3; ++k)
+            {
+                size_t& stamp = m_timestamps[triangle[k]];
+                if (m_time - stamp > VERTEX_CACHE_ANALYZE_SIZE)
+                {
+                    stamp = m_time++;
+                    ++misses;
+                }
+            }
+            return misses;
+        }
+
+        void reset() { m_time += VERTEX_CACHE_ANALYZE_SIZE + 1; }
+
+    private:
+        ScratchVector<size_t> m_timestamps;
+        size_t m_time = VERTEX_CACHE_ANALYZE_SIZE + 1;
+    };
+
+    //      .
+    // Ƹ       :    .
+    //     ,   ACMR      threshold * ACMR
+    //  :        threshold .
+    ScratchVector<size_t> clusterBoundaries(const std::vector<unsigned int>& indices, size_t vertexCount,
+        float threshold)
+    {
+        const size_t triangleCount = indices.size() / 3;
+        FifoCache cache(vertexCount);
+
+        ScratchVector<size_t> hard(scratchResource());
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            if (cache.add(&indices[t * 3]) == 3 || t == 0)
+                hard.push_back(t);
+        }
+        hard.push_back(triangleCount);
+
+        ScratchVector<size_t> boundaries(scratchResource());
+        for (size_t h = 0; h + 1 < hard.size(); ++h)
+        {
+            const size_t start = hard[h];
+            const size_t end = hard[h + 1];
+
+            cache.reset();
+            size_t misses = 0;
+            for (size_t t = start; t < end; ++t)
+                misses += cache.add(&indices[t * 3]);
+            const float target = threshold * float(misses) / float(end - start);
+
+            boundaries.push_back(start);
+
+            cache.reset();
+            size_t runMisses = 0;
+            size_t runTriangles = 0;
+            for (size_t t = start; t < end; ++t)
+            {
+                runMisses += cache.add(&indices[t * 3]);
+                ++runTriangles;
+                if (float(runMisses) <= target * float(runTriangles) && t + 1 < end)
+                {
+                    boundaries.push_back(t + 1);
+                    cache.reset(); //       
+                    runMisses = 0;
+                    runTriangles = 0;
+                }
+            }
+        }
+        return boundaries;
+    }
+
+    //   : axis   , sign     
+    struct OverdrawView {
+        int axis;
+        float sign;
+    };
+
+    const OverdrawView OVERDRAW_VIEWS[] = {
+        { 0, 1.0f }, { 0, -1.0f }, { 1, 1.0f }, { 1, -1.0f }, { 2, 1.0f }, { 2, -1.0f },
+    };
+
+    //     ,  GPU   Z:
+    //  ,      
+    void rasterizeTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c,
+        ScratchVector<float>& depth, size_t& covered, size_t& shaded)
+    {
+        float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (area == 0.0f)
+            return;
+
+        //    :    
+        const float invArea = 1.0f / area;
+
+        int minX = std::max(0, int(std::floor(std::min({ a.x, b.x, c.x }))));
+        int maxX = std::min(OVERDRAW_VIEWPORT - 1, int(std::ceil(std::max({ a.x, b.x, c.x }))));
+        int minY = std::max(0, int(std::floor(std::min({ a.y, b.y, c.y }))));
+        int maxY = std::min(OVERDRAW_VIEWPORT - 1, int(std::ceil(std::max({ a.y, b.y, c.y }))));
+
+        for (int y = minY; y <= maxY; ++y)
+        {
+            for (int x = minX; x <= maxX; ++x)
+            {
+                float px = float(x) + 0.5f;
+                float py = float(y) + 0.5f;
+
+                float w0 = ((c.x - b.x) * (py - b.y) - (c.y - b.y) * (px - b.x)) * invArea;
+                float w1 = ((a.x - c.x) * (py - c.y) - (a.y - c.y) * (px - c.x)) * invArea;
+                float w2 = 1.0f - w0 - w1;
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+                    continue;
+
+                float z = w0 * a.z + w1 * b.z + w2 * c.z;
+                float& stored = depth[size_t(y) * OVERDRAW_VIEWPORT + x];
+                if (stored == HUGE_VALF)
+                    ++covered;
+                if (z < stored)
+                {
+                    stored = z;
+                    ++shaded;
+                }
+            }
+        }
+    }
+}
+
+float analyzeOverdraw(const MeshData& data)
+{
+    const size_t triangleCount = data.indices.size() / 3;
+    if (triangleCount == 0 || data.format == VertexFormat::Packed)
+        return 0.0f;
+
+    const glm::vec3 extent = data.boundsMax - data.boundsMin;
+    const float maxExtent = std::max({ extent.x, extent.y, extent.z });
+    if (maxExtent <= 0.0f)
+        return 0.0f;
+
+    //    ,    
+    const float scale = float(OVERDRAW_VIEWPORT - 1) / maxExtent;
+
+    ScratchVector<float> depth(size_t(OVERDRAW_VIEWPORT) * OVERDRAW_VIEWPORT, scratchResource());
+    size_t covered = 0;
+    size_t shaded = 0;
+
+    for (const OverdrawView& view : OVERDRAW_VIEWS)
+    {
+        std::fill(depth.begin(), depth.end(), HUGE_VALF);
+
+        const int u = (view.axis + 1) % 3;
+        const int v = (view.axis + 2) % 3;
+        auto project = [&](unsigned int index)
+        {
+            glm::vec3 p = (data.position(index) - data.boundsMin) * scale;
+            return glm::vec3(p[u], p[v], p[view.axis] * view.sign);
+        };
+
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            rasterizeTriangle(project(data.indices[t * 3]), project(data.indices[t * 3 + 1]),
+                project(data.indices[t * 3 + 2]), depth, covered, shaded);
+        }
+    }
+
+    return covered ? float(shaded) / float(covered) : 0.0f;
+}
+
+void optimizeOverdraw(std::vector<unsigned int>& indices, const MeshData& data, float threshold)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || data.format == VertexFormat::Packed)
+        return;
+
+    ScratchVector<size_t> boundaries = clusterBoundaries(indices, data.vertexCount(), threshold);
+    const size_t clusterCount = boundaries.size();
+    boundaries.push_back(triangleCount);
+
+    //       ,    
+    ScratchVector<glm::vec3> clusterCentroid(clusterCount, glm::vec3(0.0f), scratchResource());
+    ScratchVector<glm::vec3> clusterNormal(clusterCount, glm::vec3(0.0f), scratchResource());
+    ScratchVector<float> clusterArea(clusterCount, 0.0f, scratchResource());
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+
+    for (size_t c = 0; c < clusterCount; ++c)
+    {
+        for (size_t t = boundaries[c]; t < boundaries[c + 1]; ++t)
+        {
+            const glm::vec3& a = data.position(indices[t * 3]);
+            const glm::vec3& b = data.position(indices[t * 3 + 1]);
+            const glm::vec3& p = data.position(indices[t * 3 + 2]);
+
+            glm::vec3 normal = glm::cross(b - a, p - a); //    
+            float area = glm::length(normal);
+
+            clusterCentroid[c] += (a + b + p) * (area / 3.0f);
+            clusterNormal[c] += normal;
+            clusterArea[c] += area;
+        }
+
+        meshCentroid += clusterCentroid[c];
+        meshArea += clusterArea[c];
+    }
+
+    if (meshArea > 0.0f)
+        meshCentroid /= meshArea;
+
+    // ,        , 
+    //          
+    ScratchVector<float> sortKey(clusterCount, 0.0f, scratchResource());
+    for (size_t c = 0; c < clusterCount; ++c)
+    {
+        if (clusterArea[c] <= 0.0f)
+            continue;
+
+        glm::vec3 centroid = clusterCentroid[c] / clusterArea[c];
+        float normalLength = glm::length(clusterNormal[c]);
+        if (normalLength > 0.0f)
+            sortKey[c] = glm::dot(centroid - meshCentroid, clusterNormal[c] / normalLength);
+    }
+
+    ScratchVector<size_t> order(clusterCount, scratchResource());
+    for (size_t c = 0; c < clusterCount; ++c)
+        order[c] = c;
+    std::stable_sort(order.begin(), order.end(),
+        [&sortKey](size_t l, size_t r) { return sortKey[l] > sortKey[r]; });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (size_t c : order)
+        result.insert(result.end(), indices.begin() + boundaries[c] * 3, indices.begin() + boundaries[c + 1] * 3);
+
+    indices.swap(result);
+}
+
+void optimizeMeshOverdraw(MeshData& data, float threshold)
+{
+    data.overdrawBefore = analyzeOverdraw(data);
+
+    optimizeOverdraw(data.indices, data, threshold);
+    optimizeVertexFetch(data);
+
+    data.cacheAfter = analyzeVertexCache(data.indices.data(), data.indices.size(), data.vertexCount());
+    data.overdrawAfter = analyzeOverdraw(data);
+}
+
+namespace
+{
+    //       
+    const size_t WELD_CHUNK_VERTICES = size_t(1) << 16;
+    //  -   : 2^6,      
+    const unsigned int WELD_PARTITION_BITS = 6;
+
+    // body(begin, end)   [0, count):       
+    void forEachChunk(ThreadPool* pool, size_t count, size_t chunk, const std::function<void(size_t, size_t)>& body)
+    {
+        const size_t chunks = (count + chunk - 1) / chunk;
+        if (pool && chunks > 1)
+        {
+            pool->parallelFor(chunks, [&](size_t c) { body(c * chunk, std::min(count, (c + 1) * chunk)); });
+            return;
+        }
+        for (size_t c = 0; c < chunks; ++c)
+            body(c * chunk, std::min(count, (c + 1) * chunk));
+    }
+
+    //  :    ,       
+    class WeldKey
+    {
+    public:
+        WeldKey(const unsigned char* vertices, size_t stride, float epsilon)
+            : m_vertices(vertices), m_stride(stride), m_inverse(epsilon > 0.0f ? 1.0f / epsilon : 0.0f) {}
+
+        uint64_t hash(size_t v) const
+        {
+            const unsigned char* p = m_vertices + v * m_stride;
+            uint64_t h = FNV_OFFSET_BASIS;
+            size_t offset = 0;
+            if (m_inverse > 0.0f)
+            {
+                glm::vec3 c = cell(p);
+                h = fnv1aWords(&c, sizeof(c), h);
+                offset = sizeof(glm::vec3);
+            }
+            h = fnv1aWords(p + offset, m_stride - offset, h);
+            // :       ,     
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        bool equal(size_t a, size_t b) const
+        {
+            const unsigned char* pa = m_vertices + a * m_stride;
+            const unsigned char* pb = m_vertices + b * m_stride;
+            if (m_inverse <= 0.0f)
+                return std::memcmp(pa, pb, m_stride) == 0;
+            return cell(pa) == cell(pb)
+                && std::memcmp(pa + sizeof(glm::vec3), pb + sizeof(glm::vec3), m_stride - sizeof(glm::vec3)) == 0;
+        }
+
+    private:
+        const unsigned char* m_vertices;
+        size_t m_stride;
+        float m_inverse; // 1 / epsilon; 0   
+
+        //     ; + 0.0f  -0
+        glm::vec3 cell(const unsigned char* p) const
+        {
+            glm::vec3 position;
+            std::memcpy(&position, p, sizeof(position));
+            return glm::floor(position * m_inverse + 0.5f) + 0.0f;
+        }
+    };
+}
+
+size_t weldVertices(MeshData& data, float positionEpsilon, ThreadPool* pool)
+{
+    const size_t vertexCount = data.vertexCount();
+    const size_t stride = vertexSize(data.format);
+    if (vertexCount == 0 || data.indices.empty() || data.format == VertexFormat::Packed)
+        return vertexCount;
+    data.verticesBeforeWeld = vertexCount;
+
+    const WeldKey key(data.vertices.data(), stride, positionEpsilon);
+    const size_t chunks = (vertexCount + WELD_CHUNK_VERTICES - 1) / WELD_CHUNK_VERTICES;
+    const size_t partitions = pool ? size_t(1) << WELD_PARTITION_BITS : 1;
+    auto partitionOf = [partitions](uint64_t h) { return partitions > 1 ? size_t(h >> (64 - WELD_PARTITION_BITS)) : 0; };
+
+    // 1.          
+    ScratchVector<uint64_t> hashes(vertexCount, scratchResource());
+    ScratchVector<size_t> counts(chunks * partitions, 0, scratchResource());
+    forEachChunk(pool, vertexCount, WELD_CHUNK_VERTICES, [&](size_t begin, size_t end)
+    {
+        size_t* chunkCounts = &counts[begin / WELD_CHUNK_VERTICES * partitions];
+        for (size_t v = begin; v < end; ++v)
+        {
+            hashes[v] = key.hash(v);
+            ++chunkCounts[partitionOf(hashes[v])];
+        }
+    });
+
+    // 2.   ;       (   )
+    ScratchVector<size_t> partitionStart(partitions + 1, 0, scratchResource());
+    size_t offset = 0;
+    for (size_t p = 0; p < partitions; ++p)
+    {
+        partitionStart[p] = offset;
+        for (size_t c = 0; c < chunks; ++c)
+        {
+            size_t count = counts[c * partitions + p];
+            counts[c * partitions + p] = offset;
+            offset += count;
+        }
+    }
+    partitionStart[partitions] = offset;
+
+    ScratchVector<unsigned int> order(vertexCount, scratchResource());
+    forEachChunk(pool, vertexCount, WELD_CHUNK_VERTICES, [&](size_t begin, size_t end)
+    {
+        size_t* chunkOffsets = &counts[begin / WELD_CHUNK_VERTICES * partitions];
+        for (size_t v = begin; v < end; ++v)
+            order[chunkOffsets[partitionOf(hashes[v])]++] = static_cast<unsigned int>(v);
+    });
+
+    // 3. -     : remap[v]   ,  v.
+    //   ,   
+    ScratchVector<unsigned int> remap(vertexCount, scratchResource());
+    auto weldPartition = [&](size_t p)
+    {
+        const size_t begin = partitionStart[p], end = partitionStart[p + 1];
+        size_t capacity = 16;
+        while (capacity < (end - begin) * 2)
+            capacity *= 2;
+        ScratchVector<unsigned int> table(capacity, ~0u, scratchResource());
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            const unsigned int v = order[i];
+            size_t slot = size_t(hashes[v]) & (capacity - 1);
+            while (table[slot] != ~0u && !(hashes[table[slot]] == hashes[v] && key.equal(table[slot], v)))
+                slot = (slot + 1) & (capacity - 1);
+            if (table[slot] == ~0u)
+                table[slot] = v;
+            remap[v] = table[slot];
+        }
+    };
+    if (partitions > 1)
+        pool->parallelFor(partitions, weldPartition);
+    else
+        weldPartition(0);
+
+    // 4.      : remap[v] <= v,      
+    unsigned int next = 0;
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        if (remap[v] == v)
+            remap[v] = next++;
+        else
+            remap[v] = remap[remap[v]];
+    }
+    if (next == vertexCount)
+        return vertexCount; //   ,   
+
+    std::vector<unsigned char> vertices(size_t(next) * stride);
+    unsigned int written = 0;
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        if (remap[v] == written)
+            std::memcpy(&vertices[size_t(written++) * stride], &data.vertices[v * stride], stride);
+    }
+
+    forEachChunk(pool, data.indices.size(), WELD_CHUNK_VERTICES * 3, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            data.indices[i] = remap[data.indices[i]];
+    });
+
+    //          
+    if (positionEpsilon > 0.0f)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i + 2 < data.indices.size(); i += 3)
+        {
+            const unsigned int a = data.indices[i], b = data.indices[i + 1], c = data.indices[i + 2];
+            if (a == b || b == c || a == c)
+                continue;
+            data.indices[kept++] = a;
+            data.indices[kept++] = b;
+            data.indices[kept++] = c;
+        }
+        data.indices.resize(kept);
+    }
+
+    data.vertices.swap(vertices);
+    return next;
+}
@@ -0,0 +1,334 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#include "Hash.h"
+#include "MeshOptimizer.h"
+#include "ScratchArena.h"
+
+namespace
+{
+    //      4x4:     
+    //     . error()       
+    //    ,     .
+    struct Quadric {
+        double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+        double a11 = 0, a12 = 0, a13 = 0;
+        double a22 = 0, a23 = 0;
+        double a33 = 0;
+        double weight = 0;
+
+        void addPlane(const glm::vec3& n, float d, double w)
+        {
+            double a = n.x, b = n.y, c = n.z;
+            a00 += w * a * a; a01 += w * a * b; a02 += w * a * c; a03 += w * a * d;
+            a11 += w * b * b; a12 += w * b * c; a13 += w * b * d;
+            a22 += w * c * c; a23 += w * c * d;
+            a33 += w * d * d;
+            weight += w;
+        }
+
+        void add(const Quadric& q)
+        {
+            a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+            a11 += q.a11; a12 += q.a12; a13 += q.a13;
+            a22 += q.a22; a23 += q.a23;
+            a33 += q.a33;
+            weight += q.weight;
+        }
+
+        double error(const glm::vec3& p) const
+        {
+            double x = p.x, y = p.y, z = p.z;
+            double e = a00 * x * x + 2.0 * (a01 * x * y + a02 * x * z + a03 * x)
+                + a11 * y * y + 2.0 * (a12 * y * z + a13 * y)
+                + a22 * z * z + 2.0 * a23 * z + a33;
+            return weight > 0.0 ? std::max(e, 0.0) / weight : 0.0;
+        }
+    };
+
+    //   from   to (  )
+    struct Collapse {
+        unsigned int from;
+        unsigned int to;
+        double cost; //  
+    };
+
+    struct PositionKey {
+        glm::vec3 position;
+        bool operator==(const PositionKey& other) const
+        {
+            return std::memcmp(&position, &other.position, sizeof(position)) == 0;
+        }
+    };
+
+    struct PositionKeyHash {
+        size_t operator()(const PositionKey& key) const
+        {
+            return static_cast<size_t>(fnv1a(&key.position, sizeof(key.position)));
+        }
+    };
+
+    //   from   to   
+    double collapseCost(const Quadric& from, const Quadric& to, const glm::vec3& position)
+    {
+        Quadric merged = from;
+        merged.add(to);
+        return merged.error(position);
+    }
+
+    //     ,     (~75 )
+    const float MIN_NORMAL_COSINE = 0.25f;
+}
+
+std::vector<unsigned int> simplifyMesh(const MeshData& data, const std::vector<unsigned int>& indices,
+    size_t targetIndexCount, float maxError, float& resultError)
+{
+    resultError = 0.0f;
+    std::vector<unsigned int> result = indices;
+
+    const size_t vertexCount = data.vertexCount();
+    if (data.format == VertexFormat::Packed || vertexCount == 0 || result.size() <= targetIndexCount)
+        return result;
+
+    // 1.   :        UV  
+    ScratchVector<unsigned int> welded(vertexCount, scratchResource());
+    ScratchVector<unsigned int> weldedUses(scratchResource());
+    {
+        std::pmr::unordered_map<PositionKey, unsigned int, PositionKeyHash> ids(scratchResource());
+        ids.reserve(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            auto it = ids.emplace(PositionKey{ data.position(v) }, static_cast<unsigned int>(weldedUses.size()));
+            if (it.second)
+                weldedUses.push_back(0);
+            welded[v] = it.first->second;
+            ++weldedUses[welded[v]];
+        }
+    }
+    const size_t weldedCount = weldedUses.size();
+
+    // 2.  : ,     
+    ScratchVector<char> locked(weldedCount, 0, scratchResource());
+    for (size_t w = 0; w < weldedCount; ++w)
+        locked[w] = weldedUses[w] > 1;
+
+    {
+        std::pmr::unordered_map<uint64_t, unsigned int> edgeUses(scratchResource());
+        edgeUses.reserve(result.size());
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                unsigned int a = welded[result[i + k]];
+                unsigned int b = welded[result[i + (k + 1) % 3]];
+                if (a > b)
+                    std::swap(a, b);
+                ++edgeUses[(uint64_t(a) << 32) | b];
+            }
+        }
+        for (const auto& edge : edgeUses)
+        {
+            if (edge.second != 2)
+            {
+                locked[edge.first >> 32] = 1;
+                locked[edge.first & 0xFFFFFFFFu] = 1;
+            }
+        }
+    }
+
+    // 3.     
+    ScratchVector<Quadric> quadrics(weldedCount, scratchResource());
+    for (size_t i = 0; i < result.size(); i += 3)
+    {
+        const glm::vec3& p0 = data.position(result[i]);
+        const glm::vec3& p1 = data.position(result[i + 1]);
+        const glm::vec3& p2 = data.position(result[i + 2]);
+
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float length = glm::length(normal);
+        if (length == 0.0f)
+            continue;
+        normal /= length;
+
+        float d = -glm::dot(normal, p0);
+        for (int k = 0; k < 3; ++k)
+            quadrics[welded[result[i + k]]].addPlane(normal, d, length);
+    }
+
+    // 4. :    ,       
+    const double maxCost = double(maxError) * maxError;
+    double worstCost = 0.0;
+
+    ScratchVector<unsigned int> remap(vertexCount, scratchResource());
+    ScratchVector<char> touched(weldedCount, scratchResource());
+    ScratchVector<size_t> offsets(weldedCount + 1, scratchResource());
+    ScratchVector<unsigned int> adjacency(scratchResource());
+    ScratchVector<Collapse> collapses(scratchResource());
+    ScratchVector<size_t> fill(scratchResource());
+
+    while (result.size() > targetIndexCount)
+    {
+        const size_t triangleCount = result.size() / 3;
+
+        //     
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (unsigned int index : result)
+            ++offsets[welded[index] + 1];
+        for (size_t w = 0; w < weldedCount; ++w)
+            offsets[w + 1] += offsets[w];
+        adjacency.resize(result.size());
+        {
+            fill.assign(offsets.begin(), offsets.end() - 1);
+            for (size_t t = 0; t < triangleCount; ++t)
+                for (int k = 0; k < 3; ++k)
+                    adjacency[fill[welded[result[t * 3 + k]]]++] = static_cast<unsigned int>(t);
+        }
+
+        // :       ,    
+        collapses.clear();
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                unsigned int a = result[t * 3 + k];
+                unsigned int b = result[t * 3 + (k + 1) % 3];
+                unsigned int wa = welded[a];
+                unsigned int wb = welded[b];
+                if (wa >= wb)
+                    continue;
+
+                if (!locked[wa])
+                    collapses.push_back({ a, b, collapseCost(quadrics[wa], quadrics[wb], data.position(b)) });
+                if (!locked[wb])
+                    collapses.push_back({ b, a, collapseCost(quadrics[wb], quadrics[wa], data.position(a)) });
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(),
+            [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+        for (size_t v = 0; v < vertexCount; ++v)
+            remap[v] = static_cast<unsigned int>(v);
+        std::fill(touched.begin(), touched.end(), 0);
+
+        const size_t trianglesToRemove = (result.size() - targetIndexCount) / 3;
+        size_t removed = 0;
+
+        for (const Collapse& collapse : collapses)
+        {
+            if (collapse.cost > maxCost || removed >= trianglesToRemove)
+                break;
+
+            const unsigned int from = welded[collapse.from];
+            const unsigned int to = welded[collapse.to];
+            if (touched[from] || touched[to])
+                continue;
+
+            //   from      
+            const glm::vec3& target = data.position(collapse.to);
+            bool flips = false;
+            size_t collapsedTriangles = 0;
+            for (size_t a = offsets[from]; a < offsets[from + 1] && !flips; ++a)
+            {
+                const unsigned int* tri = &result[size_t(adjacency[a]) * 3];
+                glm::vec3 before[3], after[3];
+                bool degenerate = false;
+                for (int k = 0; k < 3; ++k)
+                {
+                    before[k] = data.position(tri[k]);
+                    after[k] = welded[tri[k]] == from ? target : before[k];
+                    degenerate |= welded[tri[k]] == to;
+                }
+                if (degenerate)
+                {
+                    ++collapsedTriangles;
+                    continue;
+                }
+
+                glm::vec3 n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+                glm::vec3 n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+                float l0 = glm::length(n0);
+                float l1 = glm::length(n1);
+                flips = (l1 == 0.0f && l0 > 0.0f) || glm::dot(n0, n1) < MIN_NORMAL_COSINE * l0 * l1;
+            }
+            if (flips)
+                continue;
+
+            // from  ,             collapse.to
+            remap[collapse.from] = collapse.to;
+            quadrics[to].add(quadrics[from]);
+            worstCost = std::max(worstCost, collapse.cost);
+            removed += collapsedTriangles;
+
+            //   from :        
+            for (size_t a = offsets[from]; a < offsets[from + 1]; ++a)
+                for (int k = 0; k < 3; ++k)
+                    touched[welded[result[size_t(adjacency[a]) * 3 + k]]] = 1;
+        }
+
+        if (removed == 0)
+            break; //         
+
+        size_t write = 0;
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            unsigned int a = remap[result[t * 3]];
+            unsigned int b = remap[result[t * 3 + 1]];
+            unsigned int c = remap[result[t * 3 + 2]];
+            if (welded[a] == welded[b] || welded[b] == welded[c] || welded[a] == welded[c])
+                continue;
+
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    resultError = static_cast<float>(std::sqrt(worstCost));
+    return result;
+}
+
+void generateLods(MeshData& data)
+{
+    data.lods.clear();
+    if (data.format == VertexFormat::Packed || data.indices.empty())
+        return;
+
+    const float maxError = LOD_MAX_ERROR * glm::length(data.boundsMax - data.boundsMin);
+    const std::vector<unsigned int> full = data.indices;
+
+    MeshLod level;
+    level.indexCount = static_cast<uint32_t>(full.size());
+    data.lods.push_back(level);
+
+    //      :      
+    size_t previousCount = full.size();
+    while (data.lods.size() < MAX_MESH_LODS)
+    {
+        size_t target = previousCount / 6 * 3;
+        float error = 0.0f;
+        ScratchScope scope; //        
+        std::vector<unsigned int> lod = simplifyMesh(data, full, target, maxError, error);
+
+        //         :    
+        if (lod.empty() || lod.size() > previousCount * 3 / 4)
+            break;
+
+        optimizeVertexCache(lod, data.vertexCount());
+
+        level.firstIndex = static_cast<uint32_t>(data.indices.size());
+        level.indexCount = static_cast<uint32_t>(lod.size());
+        level.error = std::max(error, data.lods.back().error);
+        data.lods.push_back(level);
+        data.indices.insert(data.indices.end(), lod.begin(), lod.end());
+
+        previousCount = lod.size();
+    }
+
+    if (data.lods.size() == 1)
+        data.lods.clear();
+}
@@ -0,0 +1,193 @@
+#include "Meshlet.h"
+#include "Mesh.h"
+#include "ScratchArena.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+void IndexRanges::add(uint32_t firstIndex, uint32_t indexCount)
+{
+    if (!firstIndices.empty() && firstIndices.back() + indexCounts.back() == firstIndex)
+    {
+        indexCounts.back() += indexCount;
+        return;
+    }
+
+    firstIndices.push_back(firstIndex);
+    indexCounts.push_back(indexCount);
+}
+
+namespace
+{
+    //      
+    void computeMeshletBounds(const MeshData& data, Meshlet& meshlet)
+    {
+        const unsigned int* indices = &data.indices[meshlet.firstIndex];
+
+        glm::vec3 boundsMin(FLT_MAX);
+        glm::vec3 boundsMax(-FLT_MAX);
+        for (uint32_t i = 0; i < meshlet.indexCount; ++i)
+        {
+            boundsMin = glm::min(boundsMin, data.position(indices[i]));
+            boundsMax = glm::max(boundsMax, data.position(indices[i]));
+        }
+
+        glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+        float radius = 0.0f;
+        for (uint32_t i = 0; i < meshlet.indexCount; ++i)
+            radius = std::max(radius, glm::length(data.position(indices[i]) - center));
+
+        //       
+        glm::vec3 axis(0.0f);
+        for (uint32_t i = 0; i < meshlet.indexCount; i += 3)
+        {
+            const glm::vec3& p0 = data.position(indices[i]);
+            glm::vec3 normal = glm::cross(data.position(indices[i + 1]) - p0, data.position(indices[i + 2]) - p0);
+            float length = glm::length(normal);
+            if (length > 0.0f)
+                axis += normal / length;
+        }
+
+        float axisLength = glm::length(axis);
+        axis = axisLength > 0.0f ? axis / axisLength : glm::vec3(0.0f, 0.0f, 1.0f);
+
+        float minDot = 1.0f;
+        for (uint32_t i = 0; i < meshlet.indexCount && axisLength > 0.0f; i += 3)
+        {
+            const glm::vec3& p0 = data.position(indices[i]);
+            glm::vec3 normal = glm::cross(data.position(indices[i + 1]) - p0, data.position(indices[i + 2]) - p0);
+            float length = glm::length(normal);
+            if (length > 0.0f)
+                minDot = std::min(minDot, glm::dot(axis, normal / length));
+        }
+
+        meshlet.center[0] = center.x;
+        meshlet.center[1] = center.y;
+        meshlet.center[2] = center.z;
+        meshlet.radius = radius;
+        meshlet.coneAxis[0] = axis.x;
+        meshlet.coneAxis[1] = axis.y;
+        meshlet.coneAxis[2] = axis.z;
+
+        //    (  )      
+        meshlet.coneCutoff = (axisLength == 0.0f || minDot <= 0.1f) ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+void buildMeshlets(MeshData& data)
+{
+    data.meshlets.clear();
+    if (data.format == VertexFormat::Packed)
+        return;
+
+    const size_t indexCount = data.lods.empty() ? data.indices.size() : data.lods[0].indexCount;
+    const size_t triangleCount = indexCount / 3;
+
+    // stamp[v] == meshletNumber       (  1, 0    )
+    ScratchVector<uint32_t> stamp(data.vertexCount(), 0, scratchResource());
+    uint32_t meshletNumber = 1;
+    unsigned int vertices = 0;
+
+    Meshlet meshlet = {};
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        const unsigned int* tri = &data.indices[t * 3];
+
+        unsigned int newVertices = 0;
+        for (int k = 0; k < 3; ++k)
+            newVertices += stamp[tri[k]] != meshletNumber;
+
+        if (vertices + newVertices > MESHLET_MAX_VERTICES || meshlet.indexCount / 3 >= MESHLET_MAX_TRIANGLES)
+        {
+            computeMeshletBounds(data, meshlet);
+            data.meshlets.push_back(meshlet);
+
+            meshlet = {};
+            meshlet.firstIndex = static_cast<uint32_t>(t * 3);
+            ++meshletNumber;
+            vertices = 0;
+        }
+
+        for (int k = 0; k < 3; ++k)
+        {
+            if (stamp[tri[k]] != meshletNumber)
+            {
+                stamp[tri[k]] = meshletNumber;
+                ++vertices;
+            }
+        }
+        meshlet.indexCount += 3;
+    }
+
+    if (meshlet.indexCount)
+    {
+        computeMeshletBounds(data, meshlet);
+        data.meshlets.push_back(meshlet);
+    }
+}
+
+ClusterCuller::ClusterCuller(const glm::mat4& modelViewProjection, const glm::mat4& modelView, bool backfaceCulling)
+    : m_backfaceCulling(backfaceCulling)
+{
+    //     (Gribb, Hartmann);      
+    const glm::mat4& m = modelViewProjection;
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    m_planes[0] = row3 + row0; // 
+    m_planes[1] = row3 - row0; // 
+    m_planes[2] = row3 + row1; // 
+    m_planes[3] = row3 - row1; // 
+    m_planes[4] = row3 + row2; // 
+    m_planes[5] = row3 - row2; // 
+    for (glm::vec4& plane : m_planes)
+        plane /= glm::length(glm::vec3(plane));
+
+    m_cameraPosition = glm::vec3(glm::inverse(modelView) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+bool ClusterCuller::isVisible(const glm::vec3& center, float radius) const
+{
+    for (const glm::vec4& plane : m_planes)
+    {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+void ClusterCuller::cull(const Meshlet* meshlets, size_t count, IndexRanges& ranges, ClusterStats& stats) const
+{
+    ranges.clear();
+    stats.tested += count;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Meshlet& meshlet = meshlets[i];
+        const glm::vec3 center(meshlet.center[0], meshlet.center[1], meshlet.center[2]);
+
+        if (!isVisible(center, meshlet.radius))
+        {
+            ++stats.frustumCulled;
+            continue;
+        }
+
+        //     :    ,   
+        if (m_backfaceCulling)
+        {
+            const glm::vec3 axis(meshlet.coneAxis[0], meshlet.coneAxis[1], meshlet.coneAxis[2]);
+            glm::vec3 toCluster = center - m_cameraPosition;
+            if (glm::dot(toCluster, axis) >= meshlet.coneCutoff * glm::length(toCluster) + meshlet.radius)
+            {
+                ++stats.backfaceCulled;
+                continue;
+            }
+        }
+
+        ++stats.drawn;
+        ranges.add(meshlet.firstIndex, meshlet.indexCount);
+    }
+}
@@ -0,0 +1,117 @@
+#include "ModelLoader.h"
+
+ModelLoader::~ModelLoader()
+{
+    shutdown();
+}
+
+void ModelLoader::shutdown()
+{
+    m_progress.cancel = true;
+    if (m_thread.joinable())
+        m_thread.join();
+
+    if (m_state == State::Importing)
+        delete m_model; //     
+    else if (m_state == State::Uploading)
+        delete m_previous; // m_model   
+    m_model = nullptr;
+    m_previous = nullptr;
+    m_state = State::Idle;
+}
+
+void ModelLoader::start(const std::string& path, const ImportOptions& options, bool reuseBuffers)
+{
+    if (m_state != State::Idle)
+        return;
+
+    m_progress.stage = ImportStage::Reading;
+    m_progress.fraction = 0.0f;
+    m_progress.cancel = false;
+    m_cpuDone = false;
+    m_cpuOk = false;
+    m_reuseBuffers = reuseBuffers;
+
+    m_model = new Model(options);
+    m_state = State::Importing;
+
+    m_thread = std::thread([this, path]
+    {
+        m_cpuOk = m_model->importCPU(path, &m_progress);
+        m_cpuDone = true;
+    });
+}
+
+void ModelLoader::cancel()
+{
+    m_progress.cancel = true;
+}
+
+bool ModelLoader::update(Model*& current, double budgetMs)
+{
+    bool replaced = false;
+
+    if (m_state == State::Importing)
+    {
+        if (!m_cpuDone)
+            return false;
+
+        m_thread.join();
+
+        if (!m_cpuOk || m_progress.cancel)
+        {
+            delete m_model;
+            m_model = nullptr;
+            m_state = State::Idle;
+            return false;
+        }
+
+        // CPU- :   ,     
+        m_previous = current;
+        current = m_model;
+        if (m_reuseBuffers)
+            m_model->setBufferDonor(m_previous);
+        m_state = State::Uploading;
+        replaced = true;
+    }
+
+    if (m_state == State::Uploading)
+    {
+        if (m_progress.cancel && !m_reuseBuffers)
+        {
+            current = m_previous;
+            delete m_model;
+            m_model = nullptr;
+            m_previous = nullptr;
+            m_state = State::Idle;
+            return true;
+        }
+
+        bool done = m_model->uploadPending(budgetMs);
+
+        m_progress.fraction = m_model->getUploadProgress();
+
+        if (done)
+        {
+            delete m_previous;
+            m_previous = nullptr;
+            m_model = nullptr;
+            m_progress.stage = ImportStage::Done;
+            m_state = State::Idle;
+        }
+    }
+
+    return replaced;
+}
+
+const char* ModelLoader::getStageName() const
+{
+    switch (m_progress.stage.load())
+    {
+    case ImportStage::Reading:    return "Reading";
+    case ImportStage::Converting: return "Converting meshes";
+    case ImportStage::Uploading:  return "Uploading to GPU";
+    case ImportStage::Done:       return "Done";
+    }
+    return "";
+}
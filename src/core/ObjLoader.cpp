@@ -0,0 +1,717 @@
+#include "ObjLoader.h"
+#include "Bounds.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+namespace
+{
+    //     ;    ,    
+    const size_t CHUNK_BYTES = 4 * 1024 * 1024;
+    const size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+    //     :  ,       
+    const uint32_t NO_INDEX = 0xFFFFFFFFu;
+    const uint32_t RELATIVE_INDEX = 0x80000000u; //  31       + RELATIVE_BIAS
+    const uint32_t RELATIVE_BIAS = 0x40000000u;
+
+    struct Corner {
+        uint32_t v;
+        uint32_t vt;
+        uint32_t vn;
+
+        bool operator==(const Corner& other) const { return v == other.v && vt == other.vt && vn == other.vn; }
+    };
+
+    //   (o, g)   (usemtl)   firstFace 
+    struct Switch {
+        size_t firstFace;
+        bool material;    // false    
+        std::string name;
+    };
+
+    //        
+    struct Piece {
+        uint32_t mesh;
+        std::vector<Corner> vertices; //   v/vt/vn
+        std::vector<uint32_t> indices;
+    };
+
+    struct Chunk {
+        const char* begin;
+        const char* end;
+
+        //  1:    ,    
+        std::vector<float> positions; // xyz 
+        std::vector<float> texCoords; // uv
+        std::vector<float> normals;
+        std::vector<Corner> corners;
+        std::vector<uint32_t> faceSizes;
+        std::vector<Switch> switches;
+        std::vector<std::string> libraries;
+        size_t lines = 0;     //   ;        
+        std::string error;
+
+        //  :            Switch
+        size_t positionBase = 0;
+        size_t texCoordBase = 0;
+        size_t normalBase = 0;
+        std::vector<uint32_t> segmentMeshes; // segmentMeshes[0]     Switch
+
+        //  2
+        std::vector<Piece> pieces;
+    };
+
+    struct ObjMaterial {
+        glm::vec3 color = glm::vec3(1.0f);
+        std::vector<TextureRef> textures;
+        bool normalMap = false;
+    };
+
+    // ---   ---
+
+    inline const char* skipBlank(const char* p, const char* end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t'))
+            ++p;
+        return p;
+    }
+
+    inline bool parseFloat(const char*& p, const char* end, float& value)
+    {
+        p = skipBlank(p, end);
+        if (p < end && *p == '+')
+            ++p; // from_chars    
+        std::from_chars_result result = std::from_chars(p, end, value);
+        if (result.ec != std::errc())
+            return false;
+        p = result.ptr;
+        return true;
+    }
+
+    //  OBJ ( 1,     )  Corner-
+    inline bool encodeIndex(long long index, size_t localCount, uint32_t& out)
+    {
+        if (index > 0)
+        {
+            if (index > (long long)RELATIVE_INDEX - 1)
+                return false;
+            out = static_cast<uint32_t>(index - 1);
+            return true;
+        }
+        long long local = (long long)localCount + index;
+        if (index == 0 || local < -(long long)RELATIVE_BIAS || local >= (long long)RELATIVE_BIAS - 1)
+            return false;
+        out = RELATIVE_INDEX | static_cast<uint32_t>(local + RELATIVE_BIAS);
+        return true;
+    }
+
+    //      :  ,   
+    inline std::string restOfLine(const char* p, const char* end)
+    {
+        p = skipBlank(p, end);
+        while (end > p && (end[-1] == ' ' || end[-1] == '\t'))
+            --end;
+        return std::string(p, end);
+    }
+
+    inline bool keyword(const char* p, const char* end, const char* word, size_t length)
+    {
+        return size_t(end - p) > length && std::memcmp(p, word, length) == 0 && (p[length] == ' ' || p[length] == '\t');
+    }
+
+    bool parseFace(Chunk& chunk, const char* p, const char* end)
+    {
+        uint32_t count = 0;
+        for (;;)
+        {
+            p = skipBlank(p, end);
+            if (p == end)
+                break;
+
+            // v, v/vt, v//vn, v/vt/vn
+            Corner corner = { NO_INDEX, NO_INDEX, NO_INDEX };
+            long long index = 0;
+            std::from_chars_result result = std::from_chars(p, end, index);
+            if (result.ec != std::errc() || !encodeIndex(index, chunk.positions.size() / 3, corner.v))
+                return false;
+            p = result.ptr;
+
+            if (p < end && *p == '/')
+            {
+                ++p;
+                if (p < end && *p != '/')
+                {
+                    result = std::from_chars(p, end, index);
+                    if (result.ec != std::errc() || !encodeIndex(index, chunk.texCoords.size() / 2, corner.vt))
+                        return false;
+                    p = result.ptr;
+                }
+                if (p < end && *p == '/')
+                {
+                    ++p;
+                    result = std::from_chars(p, end, index);
+                    if (result.ec != std::errc() || !encodeIndex(index, chunk.normals.size() / 3, corner.vn))
+                        return false;
+                    p = result.ptr;
+                }
+            }
+            if (p < end && *p != ' ' && *p != '\t')
+                return false;
+
+            chunk.corners.push_back(corner);
+            ++count;
+        }
+
+        //       
+        if (count < 3)
+        {
+            chunk.corners.resize(chunk.corners.size() - count);
+            return true;
+        }
+        chunk.faceSizes.push_back(count);
+        return true;
+    }
+
+    void parseChunk(Chunk& chunk)
+    {
+        const char* p = chunk.begin;
+        while (p < chunk.end)
+        {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+            if (!lineEnd)
+                lineEnd = chunk.end;
+            const char* next = lineEnd < chunk.end ? lineEnd + 1 : chunk.end;
+            if (lineEnd > p && lineEnd[-1] == '\r')
+                --lineEnd;
+            ++chunk.lines;
+
+            const char* s = skipBlank(p, lineEnd);
+            bool ok = true;
+            if (s + 1 < lineEnd && s[0] == 'v')
+            {
+                if (s[1] == ' ' || s[1] == '\t')
+                {
+                    float x, y, z;
+                    const char* q = s + 1;
+                    ok = parseFloat(q, lineEnd, x) && parseFloat(q, lineEnd, y) && parseFloat(q, lineEnd, z);
+                    chunk.positions.insert(chunk.positions.end(), { x, y, z }); //    xyz  
+                }
+                else if (keyword(s, lineEnd, "vt", 2))
+                {
+                    float u, v = 0.0f;
+                    const char* q = s + 2;
+                    ok = parseFloat(q, lineEnd, u);
+                    if (ok && skipBlank(q, lineEnd) != lineEnd)
+                        ok = parseFloat(q, lineEnd, v);
+                    chunk.texCoords.insert(chunk.texCoords.end(), { u, 1.0f - v }); //  aiProcess_FlipUVs
+                }
+                else if (keyword(s, lineEnd, "vn", 2))
+                {
+                    float x, y, z;
+                    const char* q = s + 2;
+                    ok = parseFloat(q, lineEnd, x) && parseFloat(q, lineEnd, y) && parseFloat(q, lineEnd, z);
+                    chunk.normals.insert(chunk.normals.end(), { x, y, z });
+                }
+            }
+            else if (s < lineEnd && s[0] == 'f' && (s + 1 == lineEnd || s[1] == ' ' || s[1] == '\t'))
+            {
+                ok = parseFace(chunk, s + 1, lineEnd);
+            }
+            else if (keyword(s, lineEnd, "o", 1) || keyword(s, lineEnd, "g", 1))
+            {
+                chunk.switches.push_back({ chunk.faceSizes.size(), false, restOfLine(s + 1, lineEnd) });
+            }
+            else if (keyword(s, lineEnd, "usemtl", 6))
+            {
+                chunk.switches.push_back({ chunk.faceSizes.size(), true, restOfLine(s + 6, lineEnd) });
+            }
+            else if (keyword(s, lineEnd, "mtllib", 6))
+            {
+                chunk.libraries.push_back(restOfLine(s + 6, lineEnd));
+            }
+            //  (#, s, l, p,  ) 
+
+            if (!ok)
+            {
+                chunk.error = "cannot parse: " + std::string(s, std::min<size_t>(lineEnd - s, 40));
+                return;
+            }
+            p = next;
+        }
+    }
+
+    // ---  ---
+
+    void parseMaterialLibrary(const std::string& path, std::unordered_map<std::string, ObjMaterial>& materials)
+    {
+        MappedFile file;
+        if (!file.open(path))
+            return; // Assimp     
+
+        const char* p = reinterpret_cast<const char*>(file.data());
+        const char* end = p + file.size();
+        ObjMaterial* current = nullptr;
+        while (p < end)
+        {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!lineEnd)
+                lineEnd = end;
+            const char* next = lineEnd < end ? lineEnd + 1 : end;
+            if (lineEnd > p && lineEnd[-1] == '\r')
+                --lineEnd;
+
+            const char* s = skipBlank(p, lineEnd);
+            if (keyword(s, lineEnd, "newmtl", 6))
+            {
+                current = &materials[restOfLine(s + 6, lineEnd)];
+            }
+            else if (current && keyword(s, lineEnd, "Kd", 2))
+            {
+                const char* q = s + 2;
+                glm::vec3 color;
+                if (parseFloat(q, lineEnd, color.r) && parseFloat(q, lineEnd, color.g) && parseFloat(q, lineEnd, color.b))
+                    current->color = color;
+            }
+            else if (current && (keyword(s, lineEnd, "map_Kd", 6) || keyword(s, lineEnd, "map_Ks", 6)))
+            {
+                //     ,   -bm 1   
+                std::string line = restOfLine(s + 6, lineEnd);
+                size_t space = line.find_last_of(" \t");
+                std::string texturePath = space == std::string::npos ? line : line.substr(space + 1);
+                current->textures.push_back({ s[5] == 'd' ? "texture_diffuse" : "texture_specular", texturePath });
+            }
+            else if (current && (keyword(s, lineEnd, "map_Bump", 8) || keyword(s, lineEnd, "map_bump", 8)
+                || keyword(s, lineEnd, "bump", 4) || keyword(s, lineEnd, "norm", 4) || keyword(s, lineEnd, "map_Kn", 6)))
+            {
+                current->normalMap = true;
+            }
+            p = next;
+        }
+    }
+
+    // ---  2:        ---
+
+    inline uint32_t resolve(uint32_t index, size_t base)
+    {
+        if (index == NO_INDEX || !(index & RELATIVE_INDEX))
+            return index;
+        return static_cast<uint32_t>(base + (index & ~RELATIVE_INDEX) - RELATIVE_BIAS);
+    }
+
+    inline size_t hashCorner(uint32_t piece, const Corner& corner)
+    {
+        uint64_t h = (uint64_t(corner.v) * 0x9E3779B97F4A7C15ull) ^ (uint64_t(corner.vt) * 0xC2B2AE3D27D4EB4Full)
+            ^ (uint64_t(corner.vn) * 0x165667B19E3779F9ull) ^ (uint64_t(piece) << 32);
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+
+    bool buildPieces(Chunk& chunk, size_t positionCount, size_t texCoordCount, size_t normalCount)
+    {
+        //  :   ( ,   ) + 1, 0  
+        size_t capacity = 16;
+        while (capacity < chunk.corners.size() * 2)
+            capacity *= 2;
+        std::vector<std::pair<uint32_t, uint32_t>> table(capacity, { 0, 0 });
+        const size_t mask = capacity - 1;
+
+        std::vector<uint32_t> faceVertices;
+        size_t corner = 0;
+        size_t segment = 0;
+        uint32_t piece = 0;
+        bool pieceValid = false;
+
+        for (size_t f = 0; f < chunk.faceSizes.size(); ++f)
+        {
+            //   :  f  ,  firstFace <= f
+            if (!pieceValid || (segment < chunk.switches.size() && chunk.switches[segment].firstFace <= f))
+            {
+                while (segment < chunk.switches.size() && chunk.switches[segment].firstFace <= f)
+                    ++segment;
+                const uint32_t mesh = chunk.segmentMeshes[segment];
+                piece = 0;
+                while (piece < chunk.pieces.size() && chunk.pieces[piece].mesh != mesh)
+                    ++piece;
+                if (piece == chunk.pieces.size())
+                    chunk.pieces.push_back({ mesh, {}, {} });
+                pieceValid = true;
+            }
+            Piece& out = chunk.pieces[piece];
+
+            faceVertices.clear();
+            for (uint32_t k = 0; k < chunk.faceSizes[f]; ++k, ++corner)
+            {
+                const Corner& raw = chunk.corners[corner];
+                Corner c = {
+                    resolve(raw.v, chunk.positionBase),
+                    resolve(raw.vt, chunk.texCoordBase),
+                    resolve(raw.vn, chunk.normalBase)
+                };
+                if (c.v >= positionCount || (c.vt != NO_INDEX && c.vt >= texCoordCount)
+                    || (c.vn != NO_INDEX && c.vn >= normalCount))
+                {
+                    chunk.error = "face index out of range";
+                    return false;
+                }
+
+                size_t slot = hashCorner(piece, c) & mask;
+                uint32_t vertex;
+                for (;;)
+                {
+                    std::pair<uint32_t, uint32_t>& entry = table[slot];
+                    if (entry.first == 0)
+                    {
+                        vertex = static_cast<uint32_t>(out.vertices.size());
+                        out.vertices.push_back(c);
+                        entry = { piece + 1, vertex + 1 };
+                        break;
+                    }
+                    if (entry.first == piece + 1 && out.vertices[entry.second - 1] == c)
+                    {
+                        vertex = entry.second - 1;
+                        break;
+                    }
+                    slot = (slot + 1) & mask;
+                }
+                faceVertices.push_back(vertex);
+            }
+
+            // ,  aiProcess_Triangulate   
+            for (size_t k = 2; k < faceVertices.size(); ++k)
+                out.indices.insert(out.indices.end(), { faceVertices[0], faceVertices[k - 1], faceVertices[k] });
+        }
+        return true;
+    }
+
+    // ---  3: MeshData   ---
+
+    template <class V>
+    void fillVertices(const std::vector<const Piece*>& pieces, const std::vector<float>& positions,
+        const std::vector<float>& texCoords, const std::vector<float>& normals, V* out)
+    {
+        for (const Piece* piece : pieces)
+        {
+            for (const Corner& c : piece->vertices)
+            {
+                V& vertex = *out++;
+                std::memcpy(&vertex.Position, &positions[size_t(c.v) * 3], sizeof(glm::vec3));
+                if (c.vn != NO_INDEX)
+                    std::memcpy(&vertex.Normal, &normals[size_t(c.vn) * 3], sizeof(glm::vec3));
+                if constexpr (VertexTraits<V>::texCoords)
+                {
+                    if (c.vt != NO_INDEX)
+                        std::memcpy(&vertex.TexCoords, &texCoords[size_t(c.vt) * 2], sizeof(glm::vec2));
+                }
+            }
+        }
+    }
+
+    void buildMesh(const std::vector<const Piece*>& pieces, const std::vector<float>& positions,
+        const std::vector<float>& texCoords, const std::vector<float>& normals, const ObjMaterial& material,
+        MeshData& data)
+    {
+        size_t vertexCount = 0;
+        size_t indexCount = 0;
+        bool hasTexCoords = false;
+        for (const Piece* piece : pieces)
+        {
+            vertexCount += piece->vertices.size();
+            indexCount += piece->indices.size();
+            for (size_t i = 0; i < piece->vertices.size() && !hasTexCoords; ++i)
+                hasTexCoords = piece->vertices[i].vt != NO_INDEX;
+        }
+
+        //    chooseVertexFormat  aiMesh:  UV   ,  Static
+        data.format = hasTexCoords ? VertexFormat::Static : VertexFormat::PositionNormal;
+        data.vertices.assign(vertexCount * vertexSize(data.format), 0);
+        withVertexType(data.format, [&](auto* tag)
+        {
+            typedef typename std::remove_pointer<decltype(tag)>::type V;
+            if constexpr (!VertexTraits<V>::quantized)
+                fillVertices<V>(pieces, positions, texCoords, normals, data.vertexArray<V>());
+        });
+
+        data.indices.resize(indexCount);
+        unsigned int* out = data.indices.data();
+        uint32_t base = 0;
+        for (const Piece* piece : pieces)
+        {
+            for (uint32_t index : piece->indices)
+                *out++ = base + index;
+            base += static_cast<uint32_t>(piece->vertices.size());
+        }
+
+        computeBounds(data);
+
+        data.color = material.color;
+        data.textures = material.textures;
+    }
+
+    double msSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+bool isObjPath(const std::string& path)
+{
+    if (path.size() < 4)
+        return false;
+    std::string extension = path.substr(path.size() - 4);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".obj";
+}
+
+std::vector<std::string> objMaterialLibraries(const std::string& path)
+{
+    std::vector<std::string> libraries;
+    MappedFile file;
+    if (!file.open(path))
+        return libraries;
+
+    const std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+    const char* p = reinterpret_cast<const char*>(file.data());
+    const char* end = p + file.size();
+    while (p < end)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!lineEnd)
+            lineEnd = end;
+        const char* next = lineEnd < end ? lineEnd + 1 : end;
+        if (lineEnd > p && lineEnd[-1] == '\r')
+            --lineEnd;
+
+        const char* s = skipBlank(p, lineEnd);
+        if (keyword(s, lineEnd, "mtllib", 6))
+        {
+            std::string library = directory + restOfLine(s + 6, lineEnd);
+            if (std::find(libraries.begin(), libraries.end(), library) == libraries.end())
+                libraries.push_back(library);
+        }
+        p = next;
+    }
+    return libraries;
+}
+
+bool loadObj(const std::string& path, std::vector<MeshData>& meshes, std::string& reason,
+    unsigned int threads, ObjLoadStats* stats)
+{
+    meshes.clear();
+    auto parseStart = std::chrono::steady_clock::now();
+
+    MappedFile file;
+    if (!file.open(path))
+    {
+        reason = "cannot open file";
+        return false;
+    }
+
+    // 1.    
+    ThreadPool pool(threads);
+    const char* data = reinterpret_cast<const char*>(file.data());
+    const char* end = data + file.size();
+    const size_t chunkBytes = std::max(MIN_CHUNK_BYTES,
+        std::min(CHUNK_BYTES, file.size() / (size_t(pool.getThreadCount()) * 4) + 1));
+
+    std::vector<Chunk> chunks;
+    for (const char* p = data; p < end;)
+    {
+        const char* chunkEnd = p + std::min<size_t>(chunkBytes, end - p);
+        if (chunkEnd < end)
+        {
+            const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = newline ? newline + 1 : end;
+        }
+        chunks.emplace_back();
+        chunks.back().begin = p;
+        chunks.back().end = chunkEnd;
+        p = chunkEnd;
+    }
+
+    // 2.   
+    pool.parallelFor(chunks.size(), [&](size_t i) { parseChunk(chunks[i]); });
+    size_t line = 0;
+    for (const Chunk& chunk : chunks)
+    {
+        line += chunk.lines;
+        if (!chunk.error.empty())
+        {
+            reason = "line " + std::to_string(line) + ": " + chunk.error;
+            return false;
+        }
+    }
+    const double parseMs = msSince(parseStart);
+    auto buildStart = std::chrono::steady_clock::now();
+
+    // 3. :            
+    std::unordered_map<std::string, ObjMaterial> materials;
+    const std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+
+    size_t positionCount = 0, texCoordCount = 0, normalCount = 0;
+    std::unordered_map<std::string, uint32_t> meshIds; //  + '\n' + 
+    std::vector<std::string> meshMaterials;
+    std::string object, material;
+    for (Chunk& chunk : chunks)
+    {
+        chunk.positionBase = positionCount;
+        chunk.texCoordBase = texCoordCount;
+        chunk.normalBase = normalCount;
+        positionCount += chunk.positions.size() / 3;
+        texCoordCount += chunk.texCoords.size() / 2;
+        normalCount += chunk.normals.size() / 3;
+
+        for (const std::string& library : chunk.libraries)
+            parseMaterialLibrary(directory + library, materials);
+
+        //      
+        chunk.segmentMeshes.resize(chunk.switches.size() + 1, 0);
+        for (size_t s = 0; s <= chunk.switches.size(); ++s)
+        {
+            if (s > 0)
+                (chunk.switches[s - 1].material ? material : object) = chunk.switches[s - 1].name;
+
+            size_t first = s == 0 ? 0 : chunk.switches[s - 1].firstFace;
+            size_t last = s == chunk.switches.size() ? chunk.faceSizes.size() : chunk.switches[s].firstFace;
+            if (first == last)
+                continue;
+
+            auto it = meshIds.emplace(object + '\n' + material, static_cast<uint32_t>(meshMaterials.size()));
+            if (it.second)
+                meshMaterials.push_back(material);
+            chunk.segmentMeshes[s] = it.first->second;
+        }
+    }
+
+    for (const std::string& name : meshMaterials)
+    {
+        auto it = materials.find(name);
+        if (it != materials.end() && it->second.normalMap)
+        {
+            reason = "normal map needs tangents (material " + name + ")";
+            return false;
+        }
+    }
+
+    //         , 
+    std::vector<float> positions(positionCount * 3), texCoords(texCoordCount * 2), normals(normalCount * 3);
+    pool.parallelFor(chunks.size(), [&](size_t i)
+    {
+        Chunk& chunk = chunks[i];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + chunk.positionBase * 3);
+        std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), texCoords.begin() + chunk.texCoordBase * 2);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.normalBase * 3);
+        std::vector<float>().swap(chunk.positions);
+        std::vector<float>().swap(chunk.texCoords);
+        std::vector<float>().swap(chunk.normals);
+    });
+
+    // 4.  :  ,   
+    pool.parallelFor(chunks.size(), [&](size_t i)
+    {
+        buildPieces(chunks[i], positionCount, texCoordCount, normalCount);
+        std::vector<Corner>().swap(chunks[i].corners);
+    });
+    for (const Chunk& chunk : chunks)
+    {
+        if (!chunk.error.empty())
+        {
+            reason = chunk.error;
+            return false;
+        }
+    }
+
+    // 5. MeshData  ,    
+    std::vector<std::vector<const Piece*>> meshPieces(meshMaterials.size());
+    for (const Chunk& chunk : chunks)
+    {
+        for (const Piece& piece : chunk.pieces)
+            meshPieces[piece.mesh].push_back(&piece);
+    }
+
+    meshes.resize(meshMaterials.size());
+    const ObjMaterial defaultMaterial;
+    pool.parallelFor(meshes.size(), [&](size_t m)
+    {
+        auto it = materials.find(meshMaterials[m]);
+        buildMesh(meshPieces[m], positions, texCoords, normals,
+            it != materials.end() ? it->second : defaultMaterial, meshes[m]);
+    });
+
+    if (stats)
+    {
+        stats->bytes = file.size();
+        stats->chunks = chunks.size();
+        stats->threads = pool.getThreadCount();
+        stats->parseMs = parseMs;
+        stats->buildMs = msSince(buildStart);
+    }
+    return true;
+}
+
+bool writeBenchmarkObj(const std::string& path, size_t megabytes)
+{
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    // ~100    :  v, vt, vn   
+    const size_t side = std::max<size_t>(2, static_cast<size_t>(std::sqrt(double(megabytes) * 1024 * 1024 / 100.0)));
+    const size_t groups = 8;
+
+    std::vector<char> buffer;
+    buffer.reserve(1 << 20);
+    char line[160];
+    auto flush = [&](bool force)
+    {
+        if (force || buffer.size() > (1 << 20) - sizeof(line))
+        {
+            std::fwrite(buffer.data(), 1, buffer.size(), file);
+            buffer.clear();
+        }
+    };
+    auto append = [&](int length)
+    {
+        buffer.insert(buffer.end(), line, line + length);
+        flush(false);
+    };
+
+    append(std::snprintf(line, sizeof(line), "# benchmark grid %zux%zu\n", side, side));
+    for (size_t y = 0; y < side; ++y)
+    {
+        for (size_t x = 0; x < side; ++x)
+        {
+            float u = float(x) / float(side - 1);
+            float v = float(y) / float(side - 1);
+            float h = 0.05f * std::sin(u * 40.0f) * std::cos(v * 40.0f);
+            append(std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", u * 2.0f - 1.0f, h, v * 2.0f - 1.0f));
+            append(std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", u, v));
+            append(std::snprintf(line, sizeof(line), "vn %.6f %.6f %.6f\n", 0.0f, 1.0f, 0.0f));
+        }
+    }
+
+    //    ,   1
+    for (size_t y = 0; y + 1 < side; ++y)
+    {
+        if (y % ((side + groups - 1) / groups) == 0)
+            append(std::snprintf(line, sizeof(line), "g strip%zu\n", y));
+        for (size_t x = 0; x + 1 < side; ++x)
+        {
+            size_t a = y * side + x + 1, b = a + 1, c = a + side + 1, d = a + side;
+            append(std::snprintf(line, sizeof(line), "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n",
+                a, a, a, b, b, b, c, c, c, d, d, d));
+        }
+    }
+
+    flush(true);
+    return std::fclose(file) == 0;
+}
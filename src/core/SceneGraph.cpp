@@ -0,0 +1,187 @@
+#include "SceneGraph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+
+void SceneGraph::clear()
+{
+    m_parents.clear();
+    m_subtreeEnds.clear();
+    m_local.clear();
+    m_world.clear();
+    m_dirty.clear();
+    m_dirtyRoots.clear();
+    m_openPath.clear();
+    m_structureChanged = false;
+}
+
+void SceneGraph::reserve(size_t count)
+{
+    m_parents.reserve(count);
+    m_subtreeEnds.reserve(count);
+    m_local.reserve(count);
+    m_world.reserve(count);
+    m_dirty.reserve(count);
+}
+
+uint32_t SceneGraph::addNode(uint32_t parent, const glm::mat4& local)
+{
+    //  ,    ;     
+    if (parent == NO_PARENT)
+    {
+        m_openPath.clear();
+    }
+    else
+    {
+        while (!m_openPath.empty() && m_openPath.back() != parent)
+            m_openPath.pop_back();
+        if (m_openPath.empty())
+        {
+            std::cerr << "ERROR::SCENE_GRAPH::Node " << m_parents.size() << " added out of depth-first order" << std::endl;
+            return NO_PARENT;
+        }
+    }
+
+    const uint32_t node = static_cast<uint32_t>(m_parents.size());
+    m_parents.push_back(parent);
+    m_subtreeEnds.push_back(node + 1);
+    m_local.push_back(local);
+    m_world.push_back(local);
+    m_dirty.push_back(0);
+    m_openPath.push_back(node);
+    m_structureChanged = true;
+    return node;
+}
+
+void SceneGraph::setLocal(uint32_t node, const glm::mat4& local)
+{
+    m_local[node] = local;
+    if (!m_dirty[node])
+    {
+        m_dirty[node] = 1;
+        m_dirtyRoots.push_back(node);
+    }
+}
+
+void SceneGraph::updateRange(uint32_t begin, uint32_t end)
+{
+    //    :       
+    for (uint32_t node = begin; node < end; ++node)
+    {
+        const uint32_t parent = m_parents[node];
+        m_world[node] = parent == NO_PARENT ? m_local[node] : m_world[parent] * m_local[node];
+    }
+}
+
+size_t SceneGraph::update()
+{
+    if (m_structureChanged)
+        return updateAll();
+    if (m_dirtyRoots.empty())
+        return 0;
+
+    //  : ,    ,  
+    std::sort(m_dirtyRoots.begin(), m_dirtyRoots.end());
+    size_t updated = 0;
+    uint32_t coveredEnd = 0;
+    for (uint32_t root : m_dirtyRoots)
+    {
+        m_dirty[root] = 0;
+        if (root < coveredEnd)
+            continue;
+        coveredEnd = m_subtreeEnds[root];
+        updateRange(root, coveredEnd);
+        updated += coveredEnd - root;
+    }
+    m_dirtyRoots.clear();
+    return updated;
+}
+
+size_t SceneGraph::updateAll()
+{
+    const uint32_t count = static_cast<uint32_t>(m_parents.size());
+
+    if (m_structureChanged)
+    {
+        //       ;   ,   
+        for (uint32_t node = 0; node < count; ++node)
+            m_subtreeEnds[node] = node + 1;
+        for (uint32_t node = count; node-- > 0;)
+        {
+            const uint32_t parent = m_parents[node];
+            if (parent != NO_PARENT)
+                m_subtreeEnds[parent] = std::max(m_subtreeEnds[parent], m_subtreeEnds[node]);
+        }
+        m_structureChanged = false;
+    }
+
+    updateRange(0, count);
+    for (uint32_t root : m_dirtyRoots)
+        m_dirty[root] = 0;
+    m_dirtyRoots.clear();
+    return count;
+}
+
+SceneGraphBenchmark benchmarkSceneGraph(size_t nodeCount, unsigned int animatedNodes, unsigned int frames)
+{
+    SceneGraphBenchmark result;
+    result.nodes = std::max<size_t>(nodeCount, 1);
+    result.animated = std::min<unsigned int>(animatedNodes, static_cast<unsigned int>(result.nodes));
+    result.frames = frames ? frames : 1;
+
+    //    :           8 
+    SceneGraph graph;
+    graph.reserve(result.nodes);
+    std::vector<uint32_t> path;
+    uint32_t random = 12345u;
+    path.push_back(graph.addNode(SceneGraph::NO_PARENT, glm::mat4(1.0f)));
+    for (size_t i = 1; i < result.nodes; ++i)
+    {
+        random = random * 1664525u + 1013904223u;
+        const size_t keep = 1 + (random >> 16) % std::min<size_t>(path.size(), 8);
+        path.resize(keep);
+        glm::mat4 local = glm::translate(glm::mat4(1.0f), glm::vec3(0.1f * float(random % 7), 0.0f, 0.05f));
+        path.push_back(graph.addNode(path.back(), local));
+    }
+    graph.update();
+
+    //    ,   
+    std::vector<uint32_t> animated(result.animated);
+    std::vector<glm::mat4> base(result.animated);
+    for (unsigned int a = 0; a < result.animated; ++a)
+    {
+        animated[a] = static_cast<uint32_t>((a + 1) * result.nodes / (result.animated + 1));
+        base[a] = graph.getLocal(animated[a]);
+    }
+
+    auto animate = [&](unsigned int frame)
+    {
+        for (unsigned int a = 0; a < result.animated; ++a)
+            graph.setLocal(animated[a], glm::rotate(base[a], 0.01f * float(frame), glm::vec3(0.0f, 1.0f, 0.0f)));
+    };
+
+    size_t updated = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int f = 0; f < result.frames; ++f)
+    {
+        animate(f);
+        updated += graph.update();
+    }
+    result.incrementalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / result.frames;
+    result.updatedPerFrame = updated / result.frames;
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned int f = 0; f < result.frames; ++f)
+    {
+        animate(f);
+        graph.updateAll();
+    }
+    result.fullMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / result.frames;
+
+    std::cout << "Scene graph benchmark (" << result.nodes << " nodes, " << result.animated << " animated, "
+        << result.frames << " frames): incremental " << result.incrementalMs << " ms (" << result.updatedPerFrame
+        << " nodes), full " << result.fullMs << " ms per frame" << std::endl;
+    return result;
+}
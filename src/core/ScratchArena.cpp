@@ -0,0 +1,76 @@
+#include "ScratchArena.h"
+
+namespace
+{
+    //   :   ,    
+    const size_t ARENA_INITIAL_BYTES = 256 * 1024;
+
+    //         ;     
+    const size_t POOL_LARGEST_BLOCK = 64 * 1024 * 1024;
+
+    thread_local std::pmr::memory_resource* currentScratch = nullptr;
+    thread_local std::pmr::memory_resource* currentPool = nullptr; // ,   currentScratch
+}
+
+std::pmr::memory_resource* scratchResource()
+{
+    return currentScratch ? currentScratch : std::pmr::new_delete_resource();
+}
+
+void* ImportScratch::CountingResource::do_allocate(size_t bytes, size_t alignment)
+{
+    void* pointer = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    size_t now = current += bytes;
+    size_t previous = peak.load();
+    while (now > previous && !peak.compare_exchange_weak(previous, now))
+    {
+    }
+    return pointer;
+}
+
+void ImportScratch::CountingResource::do_deallocate(void* pointer, size_t bytes, size_t alignment)
+{
+    current -= bytes;
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+}
+
+std::pmr::memory_resource* ImportScratch::threadPool()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource>& pool = m_pools[std::this_thread::get_id()];
+    if (!pool)
+    {
+        std::pmr::pool_options options;
+        options.largest_required_pool_block = POOL_LARGEST_BLOCK;
+        pool.reset(new std::pmr::unsynchronized_pool_resource(options, &m_upstream));
+    }
+    return pool.get();
+}
+
+ScratchScope::ScratchScope(ImportScratch* scratch)
+    : m_previous(currentScratch), m_previousPool(currentPool)
+{
+    if (!scratch)
+        return;
+
+    currentPool = scratch->threadPool();
+    m_arena.emplace(ARENA_INITIAL_BYTES, currentPool);
+    currentScratch = &*m_arena;
+}
+
+ScratchScope::ScratchScope()
+    : m_previous(currentScratch), m_previousPool(currentPool)
+{
+    if (!currentPool)
+        return;
+
+    m_arena.emplace(ARENA_INITIAL_BYTES, currentPool);
+    currentScratch = &*m_arena;
+}
+
+ScratchScope::~ScratchScope()
+{
+    //   :       
+    currentScratch = m_previous;
+    currentPool = m_previousPool;
+}
@@ -0,0 +1,103 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = hardwareThreads();
+
+    m_workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i)
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_taskReady.notify_all();
+
+    for (std::thread& worker : m_workers)
+        worker.join();
+}
+
+unsigned int ThreadPool::hardwareThreads()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_taskReady.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_tasks.empty() && m_active == 0; });
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body)
+{
+    if (count == 0)
+        return;
+
+    std::atomic<size_t> next(0);
+
+    //  -   
+    size_t runners = std::min<size_t>(count, m_workers.size());
+    std::mutex doneMutex;
+    std::condition_variable done;
+
+    for (size_t r = 0; r < std::min<size_t>(count, m_workers.size()); ++r)
+    {
+        submit([&]
+        {
+            for (size_t i = next++; i < count; i = next++)
+                body(i);
+
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--runners == 0)
+                done.notify_one();
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    done.wait(lock, [&] { return runners == 0; });
+}
+
+void ThreadPool::workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskReady.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+
+            if (m_stop && m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            ++m_active;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_active;
+            if (m_tasks.empty() && m_active == 0)
+                m_idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,26 @@
+#include "VertexFormat.h"
+
+#include <type_traits>
+
+size_t vertexSize(VertexFormat format)
+{
+    size_t size = 0;
+    withVertexType(format, [&size](auto* tag)
+    {
+        size = sizeof(typename std::remove_pointer<decltype(tag)>::type);
+    });
+    return size;
+}
+
+const char* vertexFormatName(VertexFormat format)
+{
+    switch (format)
+    {
+    case VertexFormat::Full:           return "full";
+    case VertexFormat::Packed:         return "packed";
+    case VertexFormat::Tangent:        return "tangent";
+    case VertexFormat::Static:         return "static";
+    case VertexFormat::PositionNormal: return "position+normal";
+    }
+    return "unknown";
+}
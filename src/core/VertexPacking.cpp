@@ -0,0 +1,150 @@
+#include "VertexPacking.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <glm/gtc/packing.hpp>
+
+namespace
+{
+    glm::vec2 signNotZero(const glm::vec2& v)
+    {
+        return glm::vec2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+    }
+
+    glm::vec3 safeInverse(const glm::vec3& v)
+    {
+        return glm::vec3(
+            v.x > 0.0f ? 1.0f / v.x : 0.0f,
+            v.y > 0.0f ? 1.0f / v.y : 0.0f,
+            v.z > 0.0f ? 1.0f / v.z : 0.0f);
+    }
+}
+
+glm::vec2 octEncode(const glm::vec3& n)
+{
+    float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (sum == 0.0f)
+        return glm::vec2(0.0f);
+
+    glm::vec2 p = glm::vec2(n.x, n.y) / sum;
+    if (n.z < 0.0f)
+        p = (1.0f - glm::abs(glm::vec2(p.y, p.x))) * signNotZero(p);
+    return p;
+}
+
+glm::vec3 octDecode(const glm::vec2& e)
+{
+    glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+    if (n.z < 0.0f)
+    {
+        glm::vec2 p = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * signNotZero(glm::vec2(n.x, n.y));
+        n.x = p.x;
+        n.y = p.y;
+    }
+    return glm::normalize(n);
+}
+
+PackedVertex packVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& texCoords,
+    const glm::vec3& boundsMin, const glm::vec3& invExtent)
+{
+    PackedVertex packed = {};
+
+    glm::vec3 unorm = (position - boundsMin) * invExtent;
+    for (int i = 0; i < 3; ++i)
+        packed.Position[i] = glm::packUnorm1x16(unorm[i]);
+
+    glm::vec2 oct = octEncode(normal);
+    packed.Normal[0] = static_cast<int16_t>(glm::packSnorm1x16(oct.x));
+    packed.Normal[1] = static_cast<int16_t>(glm::packSnorm1x16(oct.y));
+
+    packed.TexCoords[0] = glm::packHalf1x16(texCoords.x);
+    packed.TexCoords[1] = glm::packHalf1x16(texCoords.y);
+
+    return packed;
+}
+
+glm::vec3 unpackPosition(const PackedVertex& vertex, const glm::vec3& boundsMin, const glm::vec3& extent)
+{
+    glm::vec3 unorm(
+        glm::unpackUnorm1x16(vertex.Position[0]),
+        glm::unpackUnorm1x16(vertex.Position[1]),
+        glm::unpackUnorm1x16(vertex.Position[2]));
+    return boundsMin + unorm * extent;
+}
+
+glm::vec3 unpackNormal(const PackedVertex& vertex)
+{
+    return octDecode(glm::vec2(
+        glm::unpackSnorm1x16(static_cast<uint16_t>(vertex.Normal[0])),
+        glm::unpackSnorm1x16(static_cast<uint16_t>(vertex.Normal[1]))));
+}
+
+glm::vec2 unpackTexCoords(const PackedVertex& vertex)
+{
+    return glm::vec2(glm::unpackHalf1x16(vertex.TexCoords[0]), glm::unpackHalf1x16(vertex.TexCoords[1]));
+}
+
+namespace
+{
+    template <class V>
+    std::vector<unsigned char> packTyped(const MeshData& data, QuantizationError& error)
+    {
+        const size_t count = data.vertexCount();
+        const V* vertices = data.vertexArray<V>();
+
+        const glm::vec3 extent = data.boundsMax - data.boundsMin;
+        const glm::vec3 invExtent = safeInverse(extent);
+
+        std::vector<unsigned char> packed(count * sizeof(PackedVertex));
+        PackedVertex* out = reinterpret_cast<PackedVertex*>(packed.data());
+
+        float maxNormalChord = 0.0f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const V& vertex = vertices[i];
+            glm::vec2 texCoords(0.0f);
+            if constexpr (VertexTraits<V>::texCoords)
+                texCoords = vertex.TexCoords;
+
+            out[i] = packVertex(vertex.Position, vertex.Normal, texCoords, data.boundsMin, invExtent);
+
+            //    ,   ,     
+            glm::vec3 dp = glm::abs(unpackPosition(out[i], data.boundsMin, extent) - vertex.Position);
+            error.position = std::max(error.position, std::max(dp.x, std::max(dp.y, dp.z)));
+
+            glm::vec2 dt = glm::abs(unpackTexCoords(out[i]) - texCoords);
+            error.texCoord = std::max(error.texCoord, std::max(dt.x, dt.y));
+
+            float length = glm::length(vertex.Normal);
+            if (length > 0.0f)
+                maxNormalChord = std::max(maxNormalChord, glm::length(vertex.Normal / length - unpackNormal(out[i])));
+        }
+        //    : acos  ,   1,  float  
+        error.normalDegrees = glm::degrees(2.0f * std::asin(glm::clamp(maxNormalChord * 0.5f, 0.0f, 1.0f)));
+
+        return packed;
+    }
+}
+
+bool packMeshVertices(MeshData& data, QuantizationError& error)
+{
+    error = QuantizationError();
+    if (data.format == VertexFormat::Packed || data.vertices.empty())
+        return false;
+
+    std::vector<unsigned char> packed;
+    withVertexType(data.format, [&](auto* tag)
+    {
+        typedef typename std::remove_pointer<decltype(tag)>::type V;
+        if constexpr (!VertexTraits<V>::quantized)
+            packed = packTyped<V>(data, error);
+    });
+
+    if (error.texCoord > MAX_PACKED_TEXCOORD_ERROR)
+        return false;
+
+    data.vertices = std::move(packed);
+    data.format = VertexFormat::Packed;
+    return true;
+}
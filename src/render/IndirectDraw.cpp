@@ -0,0 +1,125 @@
+#include "IndirectDraw.h"
+
+#include <cstring>
+#include <iostream>
+
+//  GL 4.0+,    glad  3.3
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+namespace
+{
+    typedef void (APIENTRYP MultiDrawElementsIndirectProc)(GLenum mode, GLenum type, const void* indirect,
+        GLsizei drawcount, GLsizei stride);
+
+    MultiDrawElementsIndirectProc multiDrawElementsIndirect = nullptr;
+
+    bool hasExtension(const char* name)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; ++i)
+        {
+            const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (extension && std::strcmp(extension, name) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    //       
+    void reserveBuffer(GLenum target, unsigned int buffer, size_t bytes, size_t& capacity)
+    {
+        glBindBuffer(target, buffer);
+        if (bytes > capacity)
+        {
+            capacity = bytes + bytes / 2;
+            glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+        }
+    }
+}
+
+bool IndirectDraw::loadFunctions(GLADloadproc load)
+{
+    multiDrawElementsIndirect = nullptr;
+
+    GLint major = 0;
+    GLint minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+    // baseInstance   (draw ID)   4.2  ARB_base_instance
+    const bool core = major > 4 || (major == 4 && minor >= 3);
+    if (core || (hasExtension("GL_ARB_multi_draw_indirect") && hasExtension("GL_ARB_base_instance")))
+        multiDrawElementsIndirect = reinterpret_cast<MultiDrawElementsIndirectProc>(load("glMultiDrawElementsIndirect"));
+
+    std::cout << "OpenGL " << major << "." << minor << ": "
+        << (multiDrawElementsIndirect ? "multi-draw indirect available" : "no multi-draw indirect, drawing per mesh")
+        << std::endl;
+    return multiDrawElementsIndirect != nullptr;
+}
+
+bool IndirectDraw::isSupported()
+{
+    return multiDrawElementsIndirect != nullptr;
+}
+
+DrawDataBuffer::~DrawDataBuffer()
+{
+    if (m_buffer)
+        glDeleteBuffers(1, &m_buffer);
+    if (m_texture)
+        glDeleteTextures(1, &m_texture);
+}
+
+void DrawDataBuffer::upload(const std::vector<DrawData>& drawData, unsigned int unit)
+{
+    if (!m_buffer)
+    {
+        glGenBuffers(1, &m_buffer);
+        glGenTextures(1, &m_texture);
+    }
+
+    const size_t bytes = drawData.size() * sizeof(DrawData);
+    const bool grown = bytes > m_capacity;
+    reserveBuffer(GL_TEXTURE_BUFFER, m_buffer, bytes, m_capacity);
+    if (bytes)
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, drawData.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_BUFFER, m_texture);
+    if (grown)
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_buffer); //     
+    glActiveTexture(GL_TEXTURE0);
+}
+
+IndirectDraw::~IndirectDraw()
+{
+    if (m_commandBuffer)
+        glDeleteBuffers(1, &m_commandBuffer);
+}
+
+void IndirectDraw::upload()
+{
+    if (!m_commandBuffer)
+        glGenBuffers(1, &m_commandBuffer);
+
+    //     GL_DRAW_INDIRECT_BUFFER  draw
+    const size_t commandBytes = m_commands.size() * sizeof(DrawElementsIndirectCommand);
+    reserveBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer, commandBytes, m_commandCapacity);
+    if (commandBytes)
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commandBytes, m_commands.data());
+}
+
+void IndirectDraw::draw(unsigned int indexType, size_t firstCommand, size_t count) const
+{
+    if (!multiDrawElementsIndirect || count == 0)
+        return;
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+    multiDrawElementsIndirect(GL_TRIANGLES, indexType,
+        reinterpret_cast<const void*>(firstCommand * sizeof(DrawElementsIndirectCommand)),
+        static_cast<GLsizei>(count), 0);
+}
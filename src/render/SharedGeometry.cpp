@@ -0,0 +1,132 @@
+#include <glad/glad.h>
+#include "SharedGeometry.h"
+#include "IndirectDraw.h"
+#include "Mesh.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+    //      4 :   EBO   16-,  32- 
+    size_t alignIndexOffset(size_t offset)
+    {
+        return (offset + 3) & ~size_t(3);
+    }
+}
+
+SharedGeometry::~SharedGeometry()
+{
+    for (unsigned int f = 0; f < VERTEX_FORMAT_COUNT; ++f)
+    {
+        if (m_vaos[f])
+            glDeleteVertexArrays(1, &m_vaos[f]);
+        if (m_vbos[f])
+            glDeleteBuffers(1, &m_vbos[f]);
+    }
+    if (m_ebo)
+        glDeleteBuffers(1, &m_ebo);
+    if (m_drawIdBuffer)
+        glDeleteBuffers(1, &m_drawIdBuffer);
+}
+
+bool SharedGeometry::build(std::vector<Mesh>& meshes, size_t recordCount)
+{
+    if (m_ebo || meshes.empty())
+        return false;
+
+    // 1. :     ,    
+    size_t formatBytes[VERTEX_FORMAT_COUNT] = {};
+    std::vector<size_t> vertexOffsets(meshes.size());
+    std::vector<size_t> indexOffsets(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const Mesh& mesh = meshes[i];
+        const unsigned int f = static_cast<unsigned int>(mesh.getVertexFormat());
+        vertexOffsets[i] = formatBytes[f];
+        formatBytes[f] += mesh.getVertexBytes();
+
+        indexOffsets[i] = m_indexBytes;
+        m_indexBytes = alignIndexOffset(m_indexBytes + mesh.getIndexCount() * mesh.getIndexSize());
+    }
+
+    // 2.  
+    glGenBuffers(1, &m_ebo);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_ebo);
+    glBufferData(GL_COPY_WRITE_BUFFER, m_indexBytes, nullptr, GL_STATIC_DRAW);
+
+    for (unsigned int f = 0; f < VERTEX_FORMAT_COUNT; ++f)
+    {
+        if (!formatBytes[f])
+            continue;
+
+        glGenBuffers(1, &m_vbos[f]);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_vbos[f]);
+        glBufferData(GL_COPY_WRITE_BUFFER, formatBytes[f], nullptr, GL_STATIC_DRAW);
+        m_vertexBytes += formatBytes[f];
+    }
+
+    // 3.   GPU
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const Mesh& mesh = meshes[i];
+        const unsigned int f = static_cast<unsigned int>(mesh.getVertexFormat());
+
+        glBindBuffer(GL_COPY_READ_BUFFER, mesh.getVertexBuffer());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_vbos[f]);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, vertexOffsets[i], mesh.getVertexBytes());
+
+        glBindBuffer(GL_COPY_READ_BUFFER, mesh.getIndexBuffer());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_ebo);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, indexOffsets[i],
+            mesh.getIndexCount() * mesh.getIndexSize());
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    // 4.   0..N-1  draw ID:   ,     baseInstance
+    std::vector<uint32_t> drawIds(std::max<size_t>(recordCount, 1));
+    for (size_t i = 0; i < drawIds.size(); ++i)
+        drawIds[i] = static_cast<uint32_t>(i);
+    glGenBuffers(1, &m_drawIdBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_drawIdBuffer);
+    glBufferData(GL_ARRAY_BUFFER, drawIds.size() * sizeof(uint32_t), drawIds.data(), GL_STATIC_DRAW);
+
+    // 5. VAO  , EBO 
+    for (unsigned int f = 0; f < VERTEX_FORMAT_COUNT; ++f)
+    {
+        if (!m_vbos[f])
+            continue;
+
+        glGenVertexArrays(1, &m_vaos[f]);
+        glBindVertexArray(m_vaos[f]);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbos[f]);
+        Mesh::setupVertexLayout(VertexFormat(f));
+        glBindBuffer(GL_ARRAY_BUFFER, m_drawIdBuffer);
+        glEnableVertexAttribArray(DRAW_ID_ATTRIBUTE);
+        glVertexAttribIPointer(DRAW_ID_ATTRIBUTE, 1, GL_UNSIGNED_INT, sizeof(uint32_t), nullptr);
+        glVertexAttribDivisor(DRAW_ID_ATTRIBUTE, 1);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // 6.     ;  
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        Mesh& mesh = meshes[i];
+        const VertexFormat format = mesh.getVertexFormat();
+        mesh.attachSharedBuffers(getVAO(format),
+            static_cast<int>(vertexOffsets[i] / vertexSize(format)), indexOffsets[i]);
+    }
+
+    return true;
+}
+
+unsigned int SharedGeometry::getVAOCount() const
+{
+    unsigned int count = 0;
+    for (unsigned int vao : m_vaos)
+        count += vao != 0;
+    return count;
+}
@@ -0,0 +1,157 @@
+#include "TextureLoader.h"
+#include "Hash.h"
+#include "MappedFile.h"
+
+#include <glad/glad.h>
+#include <cstring>
+#include <iostream>
+#include <stb_image.h>
+
+void ImageDeleter::operator()(unsigned char* pixels) const
+{
+    stbi_image_free(pixels);
+}
+
+DecodedTexture decodeTexture(const std::string& filename, bool hashContent)
+{
+    DecodedTexture image;
+    image.filename = filename;
+
+    unsigned char* data = nullptr;
+    MappedFile file;
+    if (hashContent && file.open(filename))
+    {
+        //    :      
+        image.contentHash = fnv1a(file.data(), file.size());
+        data = stbi_load_from_memory(file.data(), static_cast<int>(file.size()),
+            &image.width, &image.height, &image.channels, 0);
+    }
+    else
+    {
+        data = stbi_load(filename.c_str(), &image.width, &image.height, &image.channels, 0);
+    }
+
+    if (!data)
+    {
+        std::cerr << "Texture failed to load at path: " << filename << std::endl;
+        return image;
+    }
+
+    if (image.channels != 1 && image.channels != 3 && image.channels != 4)
+    {
+        std::cerr << "Unknown number of channels: " << image.channels << std::endl;
+        stbi_image_free(data);
+        return image;
+    }
+
+    image.pixels.reset(data);
+    return image;
+}
+
+namespace
+{
+    GLenum formatFor(int channels)
+    {
+        if (channels == 1)
+            return GL_RED;
+        if (channels == 3)
+            return GL_RGB;
+        return GL_RGBA;
+    }
+
+    // pixels          PBO.
+    //  mipmaps        - (TextureUploader)
+    void fillTexture(unsigned int textureID, const DecodedTexture& image, const void* pixels, bool mipmaps)
+    {
+        GLenum format = formatFor(image.channels);
+
+        glBindTexture(GL_TEXTURE_2D, textureID);
+
+        //  RGB-      4 
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, pixels);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        if (mipmaps)
+            glGenerateMipmap(GL_TEXTURE_2D);
+
+        //    
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+}
+
+unsigned int uploadTexture(const DecodedTexture& image)
+{
+    if (!image.valid())
+        return 0;
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    fillTexture(textureID, image, image.pixels.get(), true);
+
+    return textureID;
+}
+
+TextureUploader::~TextureUploader()
+{
+    if (m_buffer != 0)
+        glDeleteBuffers(1, &m_buffer);
+}
+
+bool TextureUploader::upload(unsigned int textureID, const DecodedTexture& image)
+{
+    if (!image.valid())
+        return false;
+
+    if (m_buffer == 0)
+        glGenBuffers(1, &m_buffer);
+
+    const size_t size = size_t(image.width) * image.height * image.channels;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+
+    // ""  :  GPU    ,   ,  
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!mapped)
+    {
+        //          
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        fillTexture(textureID, image, image.pixels.get(), true);
+        return true;
+    }
+
+    std::memcpy(mapped, image.pixels.get(), size);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    //   PBO   glTexImage2D    
+    fillTexture(textureID, image, nullptr, false);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    m_pendingMipmaps.push_back(textureID);
+
+    return true;
+}
+
+void TextureUploader::generateMipmaps()
+{
+    for (unsigned int textureID : m_pendingMipmaps)
+    {
+        //      ,   
+        if (!glIsTexture(textureID))
+            continue;
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    }
+    m_pendingMipmaps.clear();
+}
+
+unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma)
+{
+    std::string filename = std::string(path);
+    filename = directory + '/' + filename;
+
+    return uploadTexture(decodeTexture(filename));
+}
@@ -0,0 +1,153 @@
+#include "TextureRegistry.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+TextureRegistry& TextureRegistry::instance()
+{
+    static TextureRegistry registry;
+    return registry;
+}
+
+std::string TextureRegistry::canonicalPath(const std::string& path)
+{
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(path, error);
+    if (error)
+        return path;
+
+    // weakly_canonical  ,   
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(absolute, error);
+    if (error)
+        return absolute.lexically_normal().generic_string();
+
+    return canonical.generic_string();
+}
+
+unsigned int TextureRegistry::acquire(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_byPath.find(key);
+    if (found == m_byPath.end())
+        return 0;
+
+    ++m_entries[found->second].refCount;
+    return found->second;
+}
+
+unsigned int TextureRegistry::acquireByHash(uint64_t contentHash, const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_byHash.find(contentHash);
+    if (found == m_byHash.end())
+        return 0;
+
+    Entry& entry = m_entries[found->second];
+    ++entry.refCount;
+    if (m_byPath.emplace(key, found->second).second)
+        entry.keys.push_back(key);
+
+    return found->second;
+}
+
+unsigned int TextureRegistry::find(const std::string& key) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_byPath.find(key);
+    return found == m_byPath.end() ? 0 : found->second;
+}
+
+unsigned int TextureRegistry::detach(const std::string& key, unsigned int references)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto path = m_byPath.find(key);
+    if (path == m_byPath.end())
+        return 0;
+    Entry& entry = m_entries[path->second];
+    if (entry.keys.size() < 2)
+        return 0;
+
+    if (entry.refCount <= references)
+    {
+        //      :     key
+        for (const std::string& other : entry.keys)
+        {
+            if (other != key)
+                m_byPath.erase(other);
+        }
+        entry.keys.assign(1, key);
+        return 0;
+    }
+
+    entry.keys.erase(std::find(entry.keys.begin(), entry.keys.end(), key));
+    entry.refCount -= references;
+
+    unsigned int id = 0;
+    glGenTextures(1, &id);
+    Entry& detached = m_entries[id];
+    detached.refCount = references;
+    detached.keys.push_back(key);
+    path->second = id;
+    return id;
+}
+
+void TextureRegistry::setContentHash(unsigned int id, uint64_t contentHash)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_entries.find(id);
+    if (found == m_entries.end())
+        return;
+
+    //       :     
+    Entry& entry = found->second;
+    if (entry.contentHash != 0)
+        m_byHash.erase(entry.contentHash);
+    entry.contentHash = 0;
+    if (contentHash != 0 && m_byHash.emplace(contentHash, id).second)
+        entry.contentHash = contentHash;
+}
+
+void TextureRegistry::add(const std::string& key, unsigned int id, uint64_t contentHash)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Entry& entry = m_entries[id];
+    ++entry.refCount;
+
+    //              id
+    if (m_byPath.emplace(key, id).second)
+        entry.keys.push_back(key);
+
+    if (contentHash != 0 && m_byHash.emplace(contentHash, id).second)
+        entry.contentHash = contentHash;
+}
+
+void TextureRegistry::release(unsigned int id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_entries.find(id);
+    if (found == m_entries.end() || --found->second.refCount > 0)
+        return;
+
+    for (const std::string& key : found->second.keys)
+        m_byPath.erase(key);
+    if (found->second.contentHash != 0)
+        m_byHash.erase(found->second.contentHash);
+    m_entries.erase(found);
+
+    glDeleteTextures(1, &id);
+}
+
+size_t TextureRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}